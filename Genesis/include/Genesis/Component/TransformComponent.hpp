@@ -31,8 +31,25 @@ namespace Genesis
 		{
 			return this->has_changed;
 		}
+
+		void clearChanged()
+		{
+			this->has_changed = false;
+		}
 	};
 
 	class RootTransform : public TransformBase {};
 	class WorldTransform : public TransformBase {};
+
+	//Tag for entities whose local Transform was written since the last resolve, see TransformResolveSystem::markDirty
+	struct TransformDirty {};
+
+	//The last two fixed step states of something simulated at the tick rate, Transform always holds current
+	//render is the blend between them for this frame, it only replaces the root's Transform when building the render list
+	struct InterpolatedTransform
+	{
+		Transform previous;
+		Transform current;
+		Transform render;
+	};
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 namespace Genesis
 {
 	class JobSystem;
@@ -16,12 +18,32 @@ namespace Genesis
 
 		void run();
 
+		//A frame is update on the main thread, then simulate on a job thread while render runs on the main thread, then finishFrame
+		//So simulate builds the next frame while render draws the last one, and only update and finishFrame may touch both
+		//The simulate job first calls fixedUpdate once for every whole fixed step that's built up, then simulate with the frame time
 		virtual void update(TimeStep time_step);
-		virtual void render(TimeStep time_step);
+		virtual void fixedUpdate(TimeStep fixed_time_step);
+		virtual void simulate(TimeStep time_step);
+		virtual void render(TimeStep interpolation_value);
+		virtual void finishFrame();
 
 		void close();
 		bool isRunning();
 
+		//Fixed steps per second
+		double tick_rate = 60.0;
+
+		//Fixed steps a single frame may run, anything past that is dropped so a long stall can't snowball into longer frames
+		uint32_t max_catch_up_steps = 5;
+
+		//Frames per second run will hold to, 0 for no limit
+		double frame_rate_limit = 0.0;
+
+		inline TimeStep getFixedTimeStep() const { return 1.0 / this->tick_rate; };
+
+		//How far the time left over after the fixed steps is into the next step, from 0 to 1
+		inline TimeStep getInterpolationValue() const { return this->interpolation_value; };
+
 		//Engine Systems
 		JobSystem* job_system = nullptr;
 		InputManager* input_manager = nullptr;
@@ -30,6 +52,12 @@ namespace Genesis
 		RenderingBackend* rendering_backend = nullptr;
 		
 	protected:
+		//Sleeps for most of the time left until the next frame is due, then spins for the rest since sleeps can overshoot by a few milliseconds
+		void limitFrameRate(std::chrono::high_resolution_clock::time_point& next_frame_time);
+
 		bool is_running = true;
+
+		TimeStep fixed_time_accumulator = 0.0;
+		TimeStep interpolation_value = 0.0;
 	};
 };
\ No newline at end of file
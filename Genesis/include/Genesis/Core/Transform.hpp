@@ -79,6 +79,9 @@ namespace Genesis
 
 		static void untransformByInplace(TransformD& destination, const TransformD& origin, const TransformD& global);
 
+		//Blends from first at alpha 0 to second at alpha 1, orientation is slerped
+		static TransformD interpolate(const TransformD& first, const TransformD& second, double alpha);
+
 		static TransformD toTransformD(const TransformF& transform);
 	};
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Genesis
+{
+	//Structure of arrays TransformDs for the TransformBatch kernels, each component is its own array so one SIMD lane is one transform
+	struct TransformBatchD
+	{
+		vector<double> position_x;
+		vector<double> position_y;
+		vector<double> position_z;
+
+		vector<double> orientation_x;
+		vector<double> orientation_y;
+		vector<double> orientation_z;
+		vector<double> orientation_w;
+
+		vector<double> scale_x;
+		vector<double> scale_y;
+		vector<double> scale_z;
+
+		void resize(size_t size);
+		void clear() { this->resize(0); };
+		size_t size() const { return this->position_x.size(); };
+
+		void set(size_t index, const TransformD& transform);
+		void setIdentity(size_t index);
+		TransformD get(size_t index) const;
+	};
+
+	//Batch versions of TransformUtils::transformByInplace and TransformD::getModelMatrix
+	//Uses AVX2 when the engine is built with GENESIS_ENABLE_AVX2, otherwise SSE2, otherwise plain scalar code
+	class TransformBatch
+	{
+	public:
+		//results[i] = parents[i] * locals[i] for every i in [begin, end)
+		//results may be the same batch as parents or locals
+		static void compose(const TransformBatchD& parents, const TransformBatchD& locals, TransformBatchD& results, size_t begin, size_t end);
+
+		//results[i] = parents[parent_indices[i]] * locals[i] for every i in [begin, end), parent_indices is indexed the same as results
+		//results may be the same batch as parents, as long as no parent index is inside [begin, end)
+		static void composeIndexed(const TransformBatchD& parents, const uint32_t* parent_indices, const TransformBatchD& locals, TransformBatchD& results, size_t begin, size_t end);
+
+		//Writes end - begin matrices starting at model_matrices[0], normal_matrices is optional
+		static void getModelMatrices(const TransformBatchD& transforms, size_t begin, size_t end, matrix4F* model_matrices, matrix3F* normal_matrices = nullptr, const vector3D& position_offset = vector3D(0.0));
+
+		//Name of the kernels that were compiled in
+		static const char* getInstructionSet();
+	};
+}
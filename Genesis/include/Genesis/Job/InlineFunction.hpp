@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Genesis
+{
+	//A std::function replacement that stores the callable in place and never allocates
+	//Size is the size of the whole object, one pointer of it is used for the type erased operations
+	template<typename Signature, size_t Size = 64>
+	class InlineFunction;
+
+	template<typename Return, typename... Args, size_t Size>
+	class InlineFunction<Return(Args...), Size>
+	{
+	protected:
+		struct OperationTable
+		{
+			Return(*invoke)(void*, Args&&...);
+			void(*copy)(void*, const void*);
+			void(*move)(void*, void*);
+			void(*destroy)(void*);
+		};
+
+		template<typename Function>
+		struct Operations
+		{
+			static Return invoke(void* function, Args&&... args)
+			{
+				return (*(Function*)function)(std::forward<Args>(args)...);
+			}
+
+			static void copy(void* destination, const void* source)
+			{
+				if constexpr (std::is_copy_constructible_v<Function>)
+				{
+					new (destination) Function(*(const Function*)source);
+				}
+				else
+				{
+					GENESIS_ENGINE_ASSERT(false, "InlineFunction holds a move only callable and can't be copied");
+				}
+			}
+
+			static void move(void* destination, void* source)
+			{
+				new (destination) Function(std::move(*(Function*)source));
+			}
+
+			static void destroy(void* function)
+			{
+				((Function*)function)->~Function();
+			}
+
+			static constexpr OperationTable table = { &invoke, &copy, &move, &destroy };
+		};
+
+	public:
+		static constexpr size_t StorageSize = Size - sizeof(const OperationTable*);
+
+		InlineFunction() {};
+		InlineFunction(std::nullptr_t) {};
+
+		template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, InlineFunction>>>
+		InlineFunction(Function&& function)
+		{
+			typedef std::decay_t<Function> FunctionType;
+			static_assert(sizeof(FunctionType) <= StorageSize, "Callable is too large for InlineFunction, capture a pointer to a JobArena allocation instead");
+			static_assert(alignof(FunctionType) <= alignof(void*), "Callable is over aligned for InlineFunction");
+
+			new (this->storage) FunctionType(std::forward<Function>(function));
+			this->operations = &Operations<FunctionType>::table;
+		}
+
+		InlineFunction(const InlineFunction& other)
+		{
+			if (other.operations != nullptr)
+			{
+				other.operations->copy(this->storage, other.storage);
+				this->operations = other.operations;
+			}
+		}
+
+		InlineFunction(InlineFunction&& other)
+		{
+			if (other.operations != nullptr)
+			{
+				other.operations->move(this->storage, other.storage);
+				this->operations = other.operations;
+				other.reset();
+			}
+		}
+
+		~InlineFunction()
+		{
+			this->reset();
+		}
+
+		InlineFunction& operator=(const InlineFunction& other)
+		{
+			if (this != &other)
+			{
+				this->reset();
+				if (other.operations != nullptr)
+				{
+					other.operations->copy(this->storage, other.storage);
+					this->operations = other.operations;
+				}
+			}
+			return *this;
+		}
+
+		InlineFunction& operator=(InlineFunction&& other)
+		{
+			if (this != &other)
+			{
+				this->reset();
+				if (other.operations != nullptr)
+				{
+					other.operations->move(this->storage, other.storage);
+					this->operations = other.operations;
+					other.reset();
+				}
+			}
+			return *this;
+		}
+
+		InlineFunction& operator=(std::nullptr_t)
+		{
+			this->reset();
+			return *this;
+		}
+
+		Return operator()(Args... args) const
+		{
+			GENESIS_ENGINE_ASSERT(this->operations != nullptr, "Calling an empty InlineFunction");
+			return this->operations->invoke((void*)this->storage, std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const
+		{
+			return this->operations != nullptr;
+		}
+
+		void reset()
+		{
+			if (this->operations != nullptr)
+			{
+				this->operations->destroy(this->storage);
+				this->operations = nullptr;
+			}
+		}
+
+	protected:
+		const OperationTable* operations = nullptr;
+		alignas(void*) unsigned char storage[StorageSize];
+	};
+}
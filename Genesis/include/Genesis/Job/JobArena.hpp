@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace Genesis
+{
+	//Lock free bump allocator for job payloads that don't fit in a JobType
+	//Everything is freed at once by reset, so only use it for data that doesn't outlive the frame
+	//Destructors are never run, so only trivially destructible types can be created in it
+	class JobArena
+	{
+	public:
+		JobArena(size_t size = 4 * 1024 * 1024)
+		{
+			this->buffer = std::make_unique<uint8_t[]>(size);
+			this->size = size;
+		};
+
+		//Returns nullptr once the arena is used up, in every build
+		void* allocate(size_t allocation_size, size_t alignment = alignof(std::max_align_t))
+		{
+			//Over allocate so the block can be aligned without a CAS loop
+			const size_t start = this->offset.fetch_add(allocation_size + alignment - 1, std::memory_order_relaxed);
+
+			//The buffer itself is only aligned for new, so the address is aligned rather than the offset
+			const uintptr_t buffer_address = (uintptr_t)this->buffer.get();
+			const uintptr_t aligned_address = (buffer_address + start + alignment - 1) & ~((uintptr_t)alignment - 1);
+			if ((aligned_address + allocation_size) > (buffer_address + this->size))
+			{
+				GENESIS_ENGINE_ASSERT(false, "JobArena out of memory");
+				return nullptr;
+			}
+
+			return (void*)aligned_address;
+		};
+
+		//create and createArray return nullptr when the arena is out of memory, callers have to check
+		template<typename T, typename... Args>
+		T* create(Args&&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "JobArena never runs destructors");
+			void* memory = this->allocate(sizeof(T), alignof(T));
+			return (memory != nullptr) ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+		};
+
+		template<typename T>
+		T* createArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "JobArena never runs destructors");
+			T* array = (T*)this->allocate(sizeof(T) * count, alignof(T));
+			if (array == nullptr)
+			{
+				return nullptr;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				new (array + i) T();
+			}
+			return array;
+		};
+
+		//Only call when no job still holds an allocation, normally at the start of a frame
+		void reset()
+		{
+			this->offset.store(0, std::memory_order_relaxed);
+		};
+
+		size_t getUsedBytes()
+		{
+			return std::min(this->offset.load(std::memory_order_relaxed), this->size);
+		};
+
+	protected:
+		std::unique_ptr<uint8_t[]> buffer;
+		size_t size = 0;
+		std::atomic<size_t> offset{ 0 };
+	};
+}
@@ -1,37 +1,203 @@
 #pragma once
 
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "Genesis/Job/WorkStealingQueue.hpp"
+#include "Genesis/Job/InlineFunction.hpp"
+#include "Genesis/Job/JobArena.hpp"
 
 namespace Genesis
 {
-	typedef function<void(uint32_t)> JobType;
-	typedef std::atomic<uint16_t> JobCounter;
+	//Jobs are stored in place, captures larger than JobType::StorageSize should point at a JobArena allocation
+	typedef InlineFunction<void(uint32_t), 64> JobType;
+	typedef std::atomic<uint32_t> JobCounter;
+
+	enum class JobPriority
+	{
+		//Work the current frame is waiting on, always taken first
+		Critical,
+		Normal,
+		//Streaming and other work that may span several frames, only run once there is no frame work left
+		//Never waited on with help from waitForCounter, and must not use the frame arena since it can outlive the frame
+		Background,
+	};
 
 	struct JobStruct
 	{
 		JobType job;
 		JobCounter* job_counter = nullptr;
+		JobPriority priority = JobPriority::Normal;
+
+		//Free list link while the job is unused
+		std::atomic<uint32_t> next_free{ 0 };
 	};
 
 	class JobSystem
 	{
 	public:
-		JobSystem();
+		//thread_count of 0 uses one thread per hardware thread, minus one for the thread that waits on jobs
+		//max_jobs is the number of jobs that can be queued at once, adding more makes the caller help out until one frees up
+		JobSystem(uint32_t thread_count = 0, uint32_t max_jobs = 16384);
 		~JobSystem();
 
-		void addJob(JobType job, JobCounter* counter = nullptr);
-		void addJobs(JobType* jobs, size_t job_count, JobCounter* counter = nullptr);
+		void addJob(JobType job, JobCounter* counter = nullptr, JobPriority priority = JobPriority::Normal);
+		void addJobs(JobType* jobs, size_t job_count, JobCounter* counter = nullptr, JobPriority priority = JobPriority::Normal);
+
+		//Jobs that must run on the main thread, eg anything that makes GL calls
+		//They are run by runMainThreadJobs, or by the main thread while it's in waitForCounter
+		void addMainThreadJob(JobType job, JobCounter* counter = nullptr);
+
+		//Runs the main thread jobs that were queued before the call, returns how many were run
+		//Only call from the thread that created the JobSystem
+		uint32_t runMainThreadJobs();
+		inline bool isMainThread() { return std::this_thread::get_id() == this->main_thread_id; };
+
+		//Scratch memory for job payloads, reset by the Application at the start of every frame
+		inline JobArena& getFrameArena() { return this->frame_arena; };
+
+		inline uint32_t getNumberOfJobThreads() { return (uint32_t)this->workers.size(); };
+
+		//Job threads get ids [0, getNumberOfJobThreads()), any other thread that runs jobs while waiting uses getNumberOfJobThreads()
+		//So per thread data needs getNumberOfJobThreads() + 1 slots
+		uint32_t getCurrentThreadId();
+
+		//Runs queued frame jobs on the calling thread until the counter reaches zero
+		//Safe to call from inside a job, the waiting job's thread keeps working instead of blocking the pool
+		//Background jobs are never picked up here, so waiting on frame work can't get stuck behind a long load
+		void waitForCounter(JobCounter& counter);
+
+		//Runs a single queued frame job on the calling thread, returns false if there was nothing to run
+		bool runPendingJob();
+
+		//Runs a single background job on the calling thread when there is no job thread to spare for them, ie with only one job thread
+		//Returns false if there was nothing to run or the job threads take care of background jobs
+		bool runBackgroundJob();
+
+		//Splits [begin, end) into chunks of at least grain_size and calls function(thread_id, chunk_begin, chunk_end) for each
+		//A grain_size of 0 picks a chunk size that gives each thread a few chunks to balance uneven work
+		//The calling thread runs the first chunk and helps with the rest, returns once every chunk is done
+		template<typename Function>
+		void parallel_for_chunks(size_t begin, size_t end, size_t grain_size, const Function& function)
+		{
+			if (end <= begin)
+			{
+				return;
+			}
+
+			const size_t count = end - begin;
+			const size_t chunk_size = this->getChunkSize(count, grain_size);
+
+			if (chunk_size >= count)
+			{
+				function(this->getCurrentThreadId(), begin, end);
+				return;
+			}
 
-		inline uint32_t getNumberOfJobThreads() { return (uint32_t)this->threads.size(); };
+			JobCounter counter{ 0 };
+			for (size_t chunk_begin = begin + chunk_size; chunk_begin < end; chunk_begin += chunk_size)
+			{
+				const size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+				this->addJob([&function, chunk_begin, chunk_end](uint32_t thread_id)
+				{
+					function(thread_id, chunk_begin, chunk_end);
+				}, &counter);
+			}
 
-		static void waitForCounter(JobCounter& counter);
+			function(this->getCurrentThreadId(), begin, begin + chunk_size);
+			this->waitForCounter(counter);
+		}
+
+		//Calls function(index) for every index in [begin, end), see parallel_for_chunks
+		template<typename Function>
+		void parallel_for(size_t begin, size_t end, size_t grain_size, const Function& function)
+		{
+			this->parallel_for_chunks(begin, end, grain_size, [&function](uint32_t thread_id, size_t chunk_begin, size_t chunk_end)
+			{
+				for (size_t i = chunk_begin; i < chunk_end; i++)
+				{
+					function(i);
+				}
+			});
+		}
+
+		//Calls function(entity) for every entity in a single component EntityRegistry view
+		//The view's packed entity array is split up in place, so nothing is copied or allocated, multi component views don't have one
+		//The function may read or write the components of the entity it was given, but must not add or remove components
+		template<typename View, typename Function>
+		void parallel_each(View& view, const Function& function, size_t grain_size = 0)
+		{
+			const auto* entities = view.data();
+			this->parallel_for(0, view.size(), grain_size, [entities, &function](size_t index)
+			{
+				function(entities[index]);
+			});
+		}
 
 		//Just for Job Threads
-		moodycamel::ConcurrentQueue<JobStruct> job_queue;
-		inline bool shouldThreadsRun() { return this->should_threads_run; };
+		inline bool shouldThreadsRun() { return this->should_threads_run.load(std::memory_order_acquire); };
+		bool tryGetJob(uint32_t thread_id, JobStruct*& job, bool allow_background = false);
+		void executeJob(uint32_t thread_id, JobStruct* job);
+		void parkThread();
 
 	protected:
-		vector<std::thread> threads;
-		bool should_threads_run = true;
+		size_t getChunkSize(size_t count, size_t grain_size);
+
+		JobStruct* allocateJob();
+		void freeJob(JobStruct* job);
+
+		//Background jobs only go through the background queue
+		static constexpr size_t frame_priority_count = 2;
+
+		struct Worker
+		{
+			WorkStealingQueue<JobStruct> queues[frame_priority_count];
+			std::thread thread;
+		};
+
+		void pushJob(JobStruct* job);
+		bool tryGetFrameJob(uint32_t thread_id, JobPriority priority, JobStruct*& job);
+		bool tryGetBackgroundJob(JobStruct*& job);
+		void notifyParkedThreads();
+		void notifyWaitingThreads();
+
+		vector<std::unique_ptr<Worker>> workers;
+
+		//Fixed pool of jobs so queuing never hits the heap
+		//free_job_head packs an ABA tag in the high 32 bits and the pool index in the low 32 bits
+		std::unique_ptr<JobStruct[]> job_pool;
+		uint32_t job_pool_size = 0;
+		std::atomic<uint64_t> free_job_head{ 0 };
+
+		JobArena frame_arena;
+
+		//Frame jobs submitted from outside the job threads, or when a worker's deque is full
+		ConcurrentQueue<JobStruct*> global_queues[frame_priority_count];
+
+		ConcurrentQueue<JobStruct*> background_queue;
+		ConcurrentQueue<JobStruct*> main_thread_queue;
+		std::thread::id main_thread_id;
+
+		//Background jobs are capped so at least one job thread is always free to pick up frame work
+		uint32_t max_background_jobs = 0;
+		std::atomic<uint32_t> running_background_jobs{ 0 };
+
+		//Number of jobs sitting in each kind of queue, used so idle threads know when it's safe to sleep
+		std::atomic<int64_t> queued_jobs{ 0 };
+		std::atomic<int64_t> queued_background_jobs{ 0 };
+		std::atomic<int64_t> queued_main_thread_jobs{ 0 };
+
+		//Idle thread parking
+		std::mutex park_mutex;
+		std::condition_variable park_condition;
+		std::atomic<uint32_t> parked_threads{ 0 };
+
+		//Threads in waitForCounter with nothing left to run
+		std::condition_variable wait_condition;
+		std::atomic<uint32_t> waiting_threads{ 0 };
+
+		std::atomic<bool> should_threads_run{ true };
 	};
-};
\ No newline at end of file
+};
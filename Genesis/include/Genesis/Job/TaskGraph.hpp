@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Genesis/Job/JobSystem.hpp"
+
+namespace Genesis
+{
+	typedef uint32_t TaskNodeId;
+
+	//A dependency graph of frame stages, independent branches are run concurrently on the JobSystem
+	//Build it once, then call execute every frame
+	class TaskGraph
+	{
+	public:
+		TaskGraph() {};
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		//main_thread nodes only ever run on the JobSystem's main thread, use it for anything touching the window or GL context
+		TaskNodeId addNode(const string& name, function<void()> task, bool main_thread = false);
+
+		//before must finish before after can start
+		void addEdge(TaskNodeId before, TaskNodeId after);
+
+		//Runs every node once, blocks until the whole graph is finished
+		//Graphs with main_thread nodes must be executed from the JobSystem's main thread, others can be executed from a job
+		//With no job system the nodes run in dependency order on the calling thread
+		void execute(JobSystem* job_system);
+
+		//Node timings from the last execute, along with the critical path through the graph
+		string dump();
+
+		bool empty() { return this->nodes.empty(); };
+
+	protected:
+		struct Node
+		{
+			string name;
+			function<void()> task;
+			bool main_thread = false;
+
+			vector<TaskNodeId> successors;
+			vector<TaskNodeId> predecessors;
+			std::atomic<uint32_t> pending_dependencies{ 0 };
+
+			//Milliseconds from the start of execute
+			double start_time = 0.0;
+			double end_time = 0.0;
+			uint32_t thread_id = 0;
+		};
+
+		void buildOrder();
+		void scheduleNode(TaskNodeId node_id);
+		void runNode(TaskNodeId node_id);
+
+		vector<std::unique_ptr<Node>> nodes;
+		vector<TaskNodeId> sorted_nodes;
+		bool order_dirty = true;
+		bool has_main_thread_nodes = false;
+
+		//Per execute state
+		JobSystem* job_system = nullptr;
+		JobCounter graph_counter{ 0 };
+		std::chrono::high_resolution_clock::time_point execute_start;
+	};
+}
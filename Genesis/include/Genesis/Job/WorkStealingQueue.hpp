@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+
+namespace Genesis
+{
+	//Chase-Lev work stealing deque, based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+	//The owning thread pushes and pops from the bottom, any other thread may steal from the top
+	//Fixed capacity, push returns false when full so the caller can fall back to a shared queue
+	template<typename T>
+	class WorkStealingQueue
+	{
+	public:
+		WorkStealingQueue(size_t capacity = 4096)
+		{
+			//Round up to a power of two so indices can be masked
+			size_t size = 1;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+
+			this->mask = (int64_t)size - 1;
+			this->buffer = new std::atomic<T*>[size];
+		}
+
+		~WorkStealingQueue()
+		{
+			delete[] this->buffer;
+		}
+
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+		//Owner thread only
+		bool push(T* item)
+		{
+			int64_t bottom = this->bottom.load(std::memory_order_relaxed);
+			int64_t top = this->top.load(std::memory_order_acquire);
+
+			if ((bottom - top) > this->mask)
+			{
+				return false;
+			}
+
+			this->buffer[bottom & this->mask].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			this->bottom.store(bottom + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		//Owner thread only
+		T* pop()
+		{
+			int64_t bottom = this->bottom.load(std::memory_order_relaxed) - 1;
+			this->bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = this->top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				//Empty
+				this->bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item = this->buffer[bottom & this->mask].load(std::memory_order_relaxed);
+
+			if (top == bottom)
+			{
+				//Last item, race against any stealers
+				if (!this->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					item = nullptr;
+				}
+				this->bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return item;
+		}
+
+		//Any thread
+		T* steal()
+		{
+			int64_t top = this->top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = this->bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			T* item = this->buffer[top & this->mask].load(std::memory_order_relaxed);
+			if (!this->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				//Lost the race to another stealer or the owner
+				return nullptr;
+			}
+
+			return item;
+		}
+
+		bool empty() const
+		{
+			int64_t bottom = this->bottom.load(std::memory_order_relaxed);
+			int64_t top = this->top.load(std::memory_order_relaxed);
+			return top >= bottom;
+		}
+
+	protected:
+		//top and bottom on separate cache lines to avoid false sharing between owner and stealers
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+		alignas(64) std::atomic<T*>* buffer = nullptr;
+		int64_t mask = 0;
+	};
+}
@@ -74,11 +74,22 @@ namespace Genesis
 	{
 		uint64_t draw_calls;
 		uint64_t triangles_count;
+
+		//Vertex/index buffer and texture binds, what draw sorting tries to keep down
+		uint64_t buffer_binds;
+		uint64_t texture_binds;
+
+		//Filled in by the scene renderer through addModelStats
+		uint64_t models_drawn;
+		uint64_t models_culled;
 	};
 
 	class LegacyBackend
 	{
 	public:
+		//Instance elements are read from this attribute location onwards, after the mesh's vertex elements
+		static constexpr uint32_t instance_attribute_location = 8;
+
 		virtual ~LegacyBackend() {};
 
 		virtual vector2U getScreenSize() = 0;
@@ -136,11 +147,22 @@ namespace Genesis
 		virtual void bindIndexBuffer(IndexBuffer buffer) = 0;
 		virtual void drawIndex(uint32_t index_count, uint32_t index_offset = 0) = 0;
 
+		//Replaces the per instance data read by drawIndexInstanced, meant to be refilled every frame
+		//Element i of instance_description is read from attribute location instance_attribute_location + i
+		virtual void uploadInstanceBuffer(const void* data, uint64_t data_size, const VertexInputDescriptionCreateInfo& instance_description) = 0;
+
+		//Draws the bound vertex and index buffers once for each of instances [first_instance, first_instance + instance_count) of the instance buffer
+		virtual void drawIndexInstanced(uint32_t index_count, uint32_t instance_count, uint32_t first_instance, uint32_t index_offset = 0) = 0;
+
+		//Replaces the contents of the read only storage buffer at binding, meant to be refilled every frame
+		virtual void uploadStorageBuffer(uint32_t binding, const void* data, uint64_t data_size) = 0;
+
 		virtual void draw(VertexBuffer vertex_buffer, IndexBuffer index_buffer, uint32_t triangle_count) = 0;
 
 		virtual void dispatchCompute(uint32_t groups_x = 1, uint32_t groups_y = 1, uint32_t groups_z = 1) = 0;
 
 		//Stats
+		virtual void addModelStats(uint64_t models_drawn, uint64_t models_culled) = 0;
 		virtual FrameStats getLastFrameStats() = 0;
 	};
 }
\ No newline at end of file
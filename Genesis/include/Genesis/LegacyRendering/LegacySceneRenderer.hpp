@@ -11,25 +11,62 @@
 #include "Genesis/Rendering/SceneLightingSettings.hpp"
 #include "Genesis/Rendering/SceneRenderList.hpp"
 #include "Genesis/Rendering/RenderSettings.hpp"
+#include "Genesis/Rendering/DrawSort.hpp"
+#include "Genesis/Rendering/LightClusters.hpp"
+#include "Genesis/Job/JobSystem.hpp"
 
 namespace Genesis
 {
+	//Matches the per instance attributes in Model.vert
+	struct ModelInstance
+	{
+		matrix4F model_matrix;
+		matrix3F normal_matrix;
+	};
+
 	class LegacySceneRenderer
 	{
 	public:
-		LegacySceneRenderer(LegacyBackend* backend);
+		//Lights are binned on a job when a job system is given, otherwise on the calling thread
+		LegacySceneRenderer(LegacyBackend* backend, JobSystem* job_system = nullptr);
 		~LegacySceneRenderer();
 
 		void draw_scene(vector2U target_size, Framebuffer target_framebuffer, SceneRenderList& scene, SceneLightingSettings& lighting, RenderSettings& settings, CameraStruct& active_camera);
 
 	protected:
+		//Fills visible_models, every model is visible when culling is turned off
+		void cull_models(const SceneRenderList& render_list, const RenderSettings& settings, const matrix4F& view_projection_matrix);
+
+		//Fills draw_commands with every visible model, unsorted
+		void build_draw_commands(const SceneRenderList& render_list, const RenderSettings& settings, const vector3F& camera_position, float far_distance);
+
+		//Forward applies the ambient light and every light in one pass, Ambient is only used with lighting turned off
+		enum DrawPass { Ambient, Forward, Count };
+		ShaderProgram get_pass_program(uint32_t pass);
+
+		//Storage buffer bindings in Clusters.slib
+		enum ClusterBinding { Lights = 0, Ranges = 1, Indices = 2 };
+
 		LegacyBackend* backend;
+		JobSystem* job_system;
 
 		ShaderProgram ambient_program;
-		ShaderProgram directional_program;
-		ShaderProgram point_program;
-		//ShaderProgram spot_program;
+		ShaderProgram forward_program;
 
 		ShaderProgram gamma_correction_program;
+
+		//Indices into the render list's models that passed culling this frame, kept to reuse the allocation
+		vector<uint32_t> visible_models;
+		vector<uint8_t> visibility_results;
+
+		//Draw submission scratch, kept to reuse the allocations
+		vector<uint64_t> model_keys;
+		vector<DrawCommand> draw_commands;
+		vector<DrawCommand> sort_scratch;
+		vector<ModelInstance> model_instances;
+		flat_hash_map<const Material*, uint32_t> material_ids;
+		flat_hash_map<const Mesh*, uint32_t> mesh_ids;
+
+		LightClusters light_clusters;
 	};
 }
\ No newline at end of file
@@ -16,5 +16,85 @@ namespace Genesis
 		AxisAlignedBoundingBox(vector3F min, vector3F max) : min(min), max(max) {};
 		vector3F min;
 		vector3F max;
+
+		inline vector3F getCenter() const { return (this->min + this->max) * 0.5f; };
+		inline vector3F getExtent() const { return (this->max - this->min) * 0.5f; };
+
+		inline float getSurfaceArea() const
+		{
+			vector3F size = this->max - this->min;
+			return 2.0f * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x));
+		};
+
+		inline bool contains(const AxisAlignedBoundingBox& other) const
+		{
+			return glm::all(glm::lessThanEqual(this->min, other.min)) && glm::all(glm::greaterThanEqual(this->max, other.max));
+		};
+
+		inline bool overlaps(const AxisAlignedBoundingBox& other) const
+		{
+			return glm::all(glm::lessThanEqual(this->min, other.max)) && glm::all(glm::greaterThanEqual(this->max, other.min));
+		};
+
+		inline bool overlapsSphere(const vector3F& center, float radius) const
+		{
+			vector3F closest_point = glm::clamp(center, this->min, this->max);
+			vector3F difference = closest_point - center;
+			return glm::dot(difference, difference) <= (radius * radius);
+		};
+
+		//Slab test, inverse_direction is 1 / ray direction, returns the entry distance in hit_distance
+		inline bool intersectsRay(const vector3F& origin, const vector3F& inverse_direction, float max_distance, float& hit_distance) const
+		{
+			vector3F t1 = (this->min - origin) * inverse_direction;
+			vector3F t2 = (this->max - origin) * inverse_direction;
+			vector3F t_min = glm::min(t1, t2);
+			vector3F t_max = glm::max(t1, t2);
+
+			float enter = glm::max(glm::max(t_min.x, t_min.y), glm::max(t_min.z, 0.0f));
+			float exit = glm::min(glm::min(t_max.x, t_max.y), glm::min(t_max.z, max_distance));
+			hit_distance = enter;
+			return enter <= exit;
+		};
+
+		inline static AxisAlignedBoundingBox merge(const AxisAlignedBoundingBox& a, const AxisAlignedBoundingBox& b)
+		{
+			return AxisAlignedBoundingBox(glm::min(a.min, b.min), glm::max(a.max, b.max));
+		};
+	};
+
+	//Structure of arrays boxes stored as centers and half extents, so several can be tested at once, see Frustum::testBoxes
+	struct BoundingBoxBatch
+	{
+		vector<float> center_x;
+		vector<float> center_y;
+		vector<float> center_z;
+
+		vector<float> extent_x;
+		vector<float> extent_y;
+		vector<float> extent_z;
+
+		void resize(size_t size)
+		{
+			this->center_x.resize(size);
+			this->center_y.resize(size);
+			this->center_z.resize(size);
+			this->extent_x.resize(size);
+			this->extent_y.resize(size);
+			this->extent_z.resize(size);
+		};
+
+		void clear() { this->resize(0); };
+		size_t size() const { return this->center_x.size(); };
+
+		void set(size_t index, const vector3F& center, const vector3F& extent)
+		{
+			this->center_x[index] = center.x;
+			this->center_y[index] = center.y;
+			this->center_z[index] = center.z;
+			this->extent_x[index] = extent.x;
+			this->extent_y[index] = extent.y;
+			this->extent_z[index] = extent.z;
+		};
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+namespace Genesis
+{
+	//One draw of a model in a pass, submitted in key order
+	struct DrawCommand
+	{
+		uint64_t key;
+		uint32_t model_index;
+	};
+
+	//Packs everything that decides draw order into one integer, so sorting by it groups passes, then shaders, materials and meshes
+	//Layout from the top: pass 4 bits, shader 4 bits, material 20 bits, mesh 20 bits, depth 16 bits
+	struct DrawKey
+	{
+		static constexpr uint32_t pass_bits = 4;
+		static constexpr uint32_t shader_bits = 4;
+		static constexpr uint32_t material_bits = 20;
+		static constexpr uint32_t mesh_bits = 20;
+		static constexpr uint32_t depth_bits = 16;
+
+		static constexpr uint32_t depth_shift = 0;
+		static constexpr uint32_t mesh_shift = depth_shift + depth_bits;
+		static constexpr uint32_t material_shift = mesh_shift + mesh_bits;
+		static constexpr uint32_t shader_shift = material_shift + material_bits;
+		static constexpr uint32_t pass_shift = shader_shift + shader_bits;
+
+		//Ids past the field width wrap, which only costs some extra binds
+		inline static uint64_t pack(uint32_t pass, uint32_t shader, uint32_t material, uint32_t mesh, uint32_t depth)
+		{
+			return (((uint64_t)pass & mask(pass_bits)) << pass_shift)
+				| (((uint64_t)shader & mask(shader_bits)) << shader_shift)
+				| (((uint64_t)material & mask(material_bits)) << material_shift)
+				| (((uint64_t)mesh & mask(mesh_bits)) << mesh_shift)
+				| (((uint64_t)depth & mask(depth_bits)) << depth_shift);
+		};
+
+		inline static uint32_t getPass(uint64_t key) { return (uint32_t)((key >> pass_shift) & mask(pass_bits)); };
+
+		//Linear depth in [0, 1] to the depth field, lower draws first
+		inline static uint32_t quantizeDepth(float depth)
+		{
+			return (uint32_t)(glm::clamp(depth, 0.0f, 1.0f) * (float)mask(depth_bits));
+		};
+
+		inline static constexpr uint64_t mask(uint32_t bits) { return (1ull << bits) - 1; };
+	};
+
+	//Stable LSD radix sort on the keys, one byte per pass, bytes that are the same for every command are skipped
+	//scratch is resized to match and is only there to reuse the allocation
+	void radixSortDrawCommands(vector<DrawCommand>& commands, vector<DrawCommand>& scratch);
+}
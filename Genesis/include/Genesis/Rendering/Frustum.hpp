@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Genesis/Rendering/BoundingBox.hpp"
+
 namespace Genesis
 {
 	class Frustum
@@ -9,6 +11,16 @@ namespace Genesis
 
 		bool sphereTest(vector3F& pos, float radius);
 
+		//Conservative, boxes near a corner of the frustum can pass without actually being inside
+		bool aabbTest(const vector3F& min, const vector3F& max) const;
+
+		//Same test as aabbTest for boxes [begin, end), visible[i - begin] is set to 1 if box i passes and 0 if it doesn't
+		//Tests 8 boxes at a time with AVX, 4 with SSE, otherwise one at a time
+		void testBoxes(const BoundingBoxBatch& boxes, size_t begin, size_t end, uint8_t* visible) const;
+
+		//Name of the kernel that was compiled in
+		static const char* getInstructionSet();
+
 	private:
 		enum Plane { Right, Left, Bottom, Top, Near, Far, Count };
 		vector4F planes[Plane::Count];
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Genesis/Rendering/BoundingBox.hpp"
+#include "Genesis/Rendering/SceneRenderList.hpp"
+
+namespace Genesis
+{
+	//Matches ClusterLight in Clusters.slib, every member is a vec4 so the std430 layout has no padding
+	struct ClusterLight
+	{
+		//World space, range is 0 for directional lights
+		vector4F position_range;
+		vector4F color_intensity;
+
+		//xyz is the light direction, w the cosine of a spot light's cutoff, point lights use -2 so every direction passes
+		vector4F direction_cutoff;
+		vector4F attenuation;
+	};
+
+	//Point and spot lights binned into view space froxels, screen tiles by depth slices spaced exponentially between the camera's near and far planes
+	//Directional lights are at the start of lights and aren't binned, they light every fragment
+	struct LightClusters
+	{
+		static constexpr uint32_t size_x = 16;
+		static constexpr uint32_t size_y = 9;
+		static constexpr uint32_t size_z = 24;
+		static constexpr uint32_t cluster_count = size_x * size_y * size_z;
+
+		vector<ClusterLight> lights;
+		uint32_t directional_light_count = 0;
+
+		//Offset into light_indices and light count, two uints per cluster, ordered x then y then z
+		vector<uint32_t> cluster_ranges;
+		vector<uint32_t> light_indices;
+
+		//What the shader needs to find a fragment's cluster, from the last build
+		matrix4F view_matrix;
+		vector2F tan_half_fov;
+		float z_near = 0.0f;
+		float z_far = 0.0f;
+
+		//Only reads render_list, so it can run on a job while the draws are being sorted
+		void build(const SceneRenderList& render_list, const matrix4F& view_matrix, const Camera& camera, float aspect_ratio);
+
+	protected:
+		//View space bounds of each cluster, only rebuilt when the projection changes
+		void buildClusterBounds();
+		vector<AxisAlignedBoundingBox> cluster_bounds;
+		vector2F bounds_tan_half_fov = vector2F(0.0f);
+		float bounds_z_near = 0.0f;
+		float bounds_z_far = 0.0f;
+
+		//Lights that reach each depth slice, as indices into lights
+		vector<uint32_t> slice_lights[size_z];
+		vector<vector3F> view_positions;
+	};
+}
@@ -51,6 +51,7 @@ namespace Genesis
 			this->cutoff = cutoff;
 		}
 
+		//Half angle of the cone in degrees
 		float cutoff;
 	};
 }
\ No newline at end of file
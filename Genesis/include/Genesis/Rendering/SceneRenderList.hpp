@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Genesis/Component/ModelComponent.hpp"
+#include "Genesis/Core/TransformBatch.hpp"
 #include "Genesis/Rendering/Camera.hpp"
 #include "Genesis/Rendering/Lights.hpp"
+#include "Genesis/Scene/Ecs.hpp"
 
 namespace Genesis
 {
+	class Scene;
+	class JobSystem;
+
 	struct CameraStruct
 	{
 		Camera camera;
@@ -14,9 +19,14 @@ namespace Genesis
 
 	struct ModelStruct
 	{
-		shared_ptr<Mesh> mesh;
-		shared_ptr<Material> material;
+		//Kept alive by the render list's resource tables, so building a list doesn't touch a refcount per model
+		const Mesh* mesh;
+		const Material* material;
 		TransformD transform;
+
+		//Built from transform by buildSceneRenderList, so the renderer doesn't recompute them every pass
+		matrix4F model_matrix;
+		matrix3F normal_matrix;
 	};
 
 	struct DirectionalLightStruct
@@ -37,12 +47,87 @@ namespace Genesis
 		TransformD transform;
 	};
 
+	//Holds one reference to each mesh and material used by a list, the renderer may draw a list a frame after it was built
+	struct SceneResourceTable
+	{
+		flat_hash_map<const Mesh*, shared_ptr<Mesh>> meshes;
+		flat_hash_map<const Material*, shared_ptr<Material>> materials;
+
+		//Consecutive models usually share resources, so the last ones added skip the lookup
+		const Mesh* last_mesh = nullptr;
+		const Material* last_material = nullptr;
+
+		void addMesh(const shared_ptr<Mesh>& mesh)
+		{
+			if (mesh.get() != this->last_mesh)
+			{
+				this->meshes.try_emplace(mesh.get(), mesh);
+				this->last_mesh = mesh.get();
+			}
+		};
+
+		void addMaterial(const shared_ptr<Material>& material)
+		{
+			if (material.get() != this->last_material)
+			{
+				this->materials.try_emplace(material.get(), material);
+				this->last_material = material.get();
+			}
+		};
+
+		void merge(const SceneResourceTable& other)
+		{
+			this->meshes.insert(other.meshes.begin(), other.meshes.end());
+			this->materials.insert(other.materials.begin(), other.materials.end());
+		};
+
+		void clear()
+		{
+			this->meshes.clear();
+			this->materials.clear();
+			this->last_mesh = nullptr;
+			this->last_material = nullptr;
+		};
+	};
+
+	//Part of a render list filled by a single job from a contiguous range of the resolved hierarchy
+	struct SceneRenderListChunk
+	{
+		vector<ModelStruct> models;
+		vector<DirectionalLightStruct> directional_lights;
+		vector<PointLightStruct> point_lights;
+		vector<SpotLightStruct> spot_lights;
+		SceneResourceTable resources;
+
+		void clear()
+		{
+			models.clear();
+			directional_lights.clear();
+			point_lights.clear();
+			spot_lights.clear();
+			resources.clear();
+		}
+	};
+
 	struct SceneRenderList
 	{
 		vector<ModelStruct> models;
 		vector<DirectionalLightStruct> directional_lights;
 		vector<PointLightStruct> point_lights;
 		vector<SpotLightStruct> spot_lights;
+		SceneResourceTable resources;
+
+		//Scratch copy of the model transforms for the batch matrix kernels, kept around to reuse the allocation
+		TransformBatchD model_transforms;
+
+		//World space bounds of each model's mesh, indexed the same as models
+		BoundingBoxBatch model_bounds;
+
+		//Per job extraction scratch, merged in hierarchy order so the list comes out the same however the jobs ran
+		vector<SceneRenderListChunk> chunks;
+
+		//Roots without a Transform, their trees aren't part of the resolved hierarchy
+		vector<EntityHandle> roots;
 
 		void clear()
 		{
@@ -50,6 +135,32 @@ namespace Genesis
 			directional_lights.clear();
 			point_lights.clear();
 			spot_lights.clear();
+			resources.clear();
 		}
 	};
+
+	//Render lists for a pipelined frame: the simulation builds the write list for the next frame while the renderer draws the read list
+	//swap is called once both are finished, so neither side ever needs a lock
+	struct SceneRenderListBuffer
+	{
+		static constexpr size_t buffer_count = 2;
+
+		SceneRenderList& getWriteList() { return this->lists[this->write_index]; };
+		SceneRenderList& getReadList() { return this->lists[(this->write_index + buffer_count - 1) % buffer_count]; };
+
+		void swap()
+		{
+			this->write_index = (this->write_index + 1) % buffer_count;
+		};
+
+	protected:
+		SceneRenderList lists[buffer_count];
+		size_t write_index = 0;
+	};
+
+	//Clears render_list and fills it with every model and light in the scene
+	//World transforms are read from TransformResolveSystem's hierarchy cache, so it has to have run since the hierarchy last changed
+	//The cache is split into chunks across the job system when one is given, the result is the same either way
+	//Only reads the registry, nothing may add or remove components while it runs
+	void buildSceneRenderList(Scene* scene, SceneRenderList& render_list, JobSystem* job_system = nullptr);
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include "Genesis/Resource/TexturePool.hpp"
 #include "Genesis/Resource/Material.hpp"
 
+namespace YAML
+{
+	class Node;
+}
+
 namespace Genesis
 {
 	class MaterialPool : public ResourcePool<string, Material>
@@ -11,10 +16,17 @@ namespace Genesis
 	public:
 		MaterialPool(TexturePool* texture_pool);
 
+		//Textures a parsed material file uses, safe on any thread so they can be read ahead of createResource
+		static void getTextureNames(const YAML::Node& material_node, vector<string>& texture_names);
+
+		//Builds a material from an already parsed file and adds it to the pool, textures not in the texture pool yet are loaded on the spot
+		shared_ptr<Material> createResource(const string& key, const YAML::Node& material_node);
+
 	protected:
 		LegacyBackend* backend = nullptr;
 		TexturePool* texture_pool = nullptr;
 
 		virtual shared_ptr<Material> loadResource(const string& key) override;
+		shared_ptr<Material> createMaterial(const string& key, const YAML::Node& material_node);
 	};
 }
\ No newline at end of file
@@ -2,10 +2,9 @@
 
 #include "Genesis/Resource/ResourcePool.hpp"
 #include "Genesis/Resource/Mesh.hpp"
+#include "Genesis/Resource/ObjLoader.hpp"
 #include "Genesis/LegacyBackend/LegacyBackend.hpp"
 
-#include "Genesis/Resource/Mesh.hpp"
-
 namespace Genesis
 {
 	class MeshPool : public ResourcePool<string, Mesh>
@@ -13,6 +12,9 @@ namespace Genesis
 	public:
 		MeshPool(LegacyBackend* backend);
 
+		//Makes the GPU buffers for a mesh read with ObjLoader::readMesh and adds it to the pool
+		shared_ptr<Mesh> createResource(const string& key, const MeshData& mesh_data);
+
 	protected:
 		LegacyBackend* backend = nullptr;
 		virtual shared_ptr<Mesh> loadResource(const string& key) override;
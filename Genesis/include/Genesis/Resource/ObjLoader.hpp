@@ -1,12 +1,27 @@
 #pragma once
 
 #include "Genesis/Resource/Mesh.hpp"
+#include "Genesis/Resource/VertexStructs.hpp"
 #include "Genesis/LegacyBackend/LegacyBackend.hpp"
 
 namespace Genesis
 {
+	//A mesh read into memory but not uploaded yet
+	struct MeshData
+	{
+		vector<MeshVertex> vertices;
+		vector<uint32_t> indices;
+		BoundingBox bounding_box;
+	};
+
 	struct ObjLoader
 	{
 		static MeshStruct loadMesh(LegacyBackend* backend, const string& filename);
+
+		//Doesn't touch the backend, so it can be used from any thread
+		static MeshData readMesh(const string& filename);
+
+		//Main thread only, makes the GPU buffers for the data
+		static MeshStruct createMesh(LegacyBackend* backend, const MeshData& mesh_data);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Genesis/Resource/Resource.hpp"
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Component/TransformComponent.hpp"
+
+namespace Genesis
+{
+	class ResourceManager;
+
+	//An entity subtree written by SceneSerializer::serializeEntity, loaded once and then stamped out as many times as needed
+	//The subtree is deserialized into its own scene, so meshes and materials are looked up once per prefab rather than once per instance
+	class Prefab : public Resource
+	{
+	public:
+		Prefab(const string& file_path, ResourceManager* resource_manager);
+
+		//Creates count copies of the subtree, instance i's root is placed at transforms[i] applied to the prefab root's own transform
+		//Every pool the prefab uses is reserved once and filled a whole node at a time, root handles are appended to roots if given
+		//Not safe to call on the same Prefab from more than one thread at once, even into different scenes, since the instance scratch is shared
+		void instantiate(Scene* scene, const Transform* transforms, size_t count, vector<EntityHandle>* roots = nullptr);
+
+		size_t getNodeCount() const { return this->nodes.size(); };
+
+		//Instance entities are laid out node by node, entities[node * count + instance]
+		typedef void(*InstantiateFunction)(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, size_t count);
+
+		//Registering the same type again replaces its function
+		template<typename T>
+		static void registerComponent()
+		{
+			Prefab::registerComponent(TypeInfo<T>::getHash(), &Prefab::instantiateComponent<T>);
+		};
+		static void registerComponent(size_t type_hash, InstantiateFunction instantiate_function);
+
+		template<typename T>
+		static void instantiateComponent(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, size_t count)
+		{
+			EntityRegistry& template_registry = prefab.template_scene.registry;
+
+			size_t total_count = 0;
+			for (const PrefabNode& node : prefab.nodes)
+			{
+				total_count += template_registry.has<T>(node.template_entity) ? count : 0;
+			}
+
+			if (total_count == 0)
+			{
+				return;
+			}
+
+			registry.reserve<T>(registry.size<T>() + total_count);
+			for (size_t i = 0; i < prefab.nodes.size(); i++)
+			{
+				if (template_registry.has<T>(prefab.nodes[i].template_entity))
+				{
+					const EntityHandle* first = entities.data() + (i * count);
+					registry.insert<T>(first, first + count, template_registry.get<T>(prefab.nodes[i].template_entity));
+				}
+			}
+		};
+
+	protected:
+		//Breadth first, so node 0 is the root and parents come before their children
+		struct PrefabNode
+		{
+			static constexpr uint32_t no_node = UINT32_MAX;
+
+			EntityHandle template_entity;
+			uint32_t parent = no_node;
+			uint32_t prev = no_node;
+			uint32_t next = no_node;
+			uint32_t first_child = no_node;
+			uint32_t last_child = no_node;
+			uint32_t child_count = 0;
+		};
+
+		static void instantiateTransforms(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, const Transform* transforms, size_t count);
+		static void instantiateHierarchy(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, size_t count);
+
+		Scene template_scene;
+		vector<PrefabNode> nodes;
+
+		//Per instance scratch, kept so repeated spawns don't reallocate
+		vector<EntityHandle> instance_entities;
+	};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Genesis/Resource/ResourcePool.hpp"
+#include "Genesis/Resource/Prefab.hpp"
+
+namespace Genesis
+{
+	class ResourceManager;
+
+	class PrefabPool : public ResourcePool<string, Prefab>
+	{
+	public:
+		PrefabPool(ResourceManager* resource_manager);
+
+	protected:
+		ResourceManager* resource_manager = nullptr;
+		virtual shared_ptr<Prefab> loadResource(const string& key) override;
+	};
+}
@@ -5,6 +5,7 @@
 #include "Genesis/Resource/MeshPool.hpp"
 #include "Genesis/Resource/TexturePool.hpp"
 #include "Genesis/Resource/MaterialPool.hpp"
+#include "Genesis/Resource/PrefabPool.hpp"
 
 #include "Genesis/Resource/Mesh.hpp"
 #include "Genesis/Resource/Texture.hpp"
@@ -16,10 +17,11 @@ namespace Genesis
 	{
 	public:
 		ResourceManager(LegacyBackend* backend)
-		:mesh_pool(backend), texture_pool(backend), material_pool(&this->texture_pool){};
+		:mesh_pool(backend), texture_pool(backend), material_pool(&this->texture_pool), prefab_pool(this){};
 
 		MeshPool mesh_pool;
 		TexturePool texture_pool;
 		MaterialPool material_pool;
+		PrefabPool prefab_pool;
 	};
 }
\ No newline at end of file
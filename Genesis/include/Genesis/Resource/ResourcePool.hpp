@@ -35,5 +35,18 @@ namespace Genesis
 
 			return resource;
 		}
+
+		//True if the resource is loaded and still in use somewhere, so getResource won't have to load it
+		bool hasResource(const key_type& key)
+		{
+			auto resource_it = this->resources.find(key);
+			return resource_it != this->resources.end() && !resource_it->second.expired();
+		}
+
+		//For resources loaded some other way, eg read on a job and finished on the main thread
+		void addResource(const key_type& key, shared_ptr<resource_type> resource)
+		{
+			this->resources[key] = resource;
+		}
 	};
 }
\ No newline at end of file
@@ -6,13 +6,30 @@
 
 namespace Genesis
 {
+	//An image read into memory but not uploaded yet
+	struct TextureData
+	{
+		vector2I size = vector2I(0);
+		int32_t channels = 0;
+		std::unique_ptr<uint8_t, void(*)(uint8_t*)> pixels{ nullptr, &TextureData::freePixels };
+
+		static void freePixels(uint8_t* pixels);
+	};
+
 	class TexturePool : public ResourcePool<string, Texture>
 	{
 	public:
 		TexturePool(LegacyBackend* backend);
 
+		//Doesn't touch the backend, so it can be used from any thread
+		static TextureData readTexture(const string& key);
+
+		//Uploads a texture read with readTexture and adds it to the pool
+		shared_ptr<Texture> createResource(const string& key, const TextureData& texture_data);
+
 	protected:
 		LegacyBackend* backend = nullptr;
 		virtual shared_ptr<Texture> loadResource(const string& key) override;
+		shared_ptr<Texture> uploadTexture(const string& key, const TextureData& texture_data);
 	};
  }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Genesis/Scene/Ecs.hpp"
+#include "Genesis/Rendering/BoundingBox.hpp"
+
+namespace Genesis
+{
+	//Bounding volume hierarchy that's updated in place as things move, kept balanced with AVL style rotations
+	//Leaves store a fattened box so small movements don't have to touch the tree at all
+	//Queries only read the tree, so any number can run at once as long as nothing is modifying it
+	class DynamicAabbTree
+	{
+	public:
+		static constexpr int32_t null_node = -1;
+
+		DynamicAabbTree(float margin = 0.1f);
+
+		int32_t createProxy(const AxisAlignedBoundingBox& bounds, EntityHandle entity);
+		void destroyProxy(int32_t proxy);
+
+		//Returns true if the proxy had to be reinserted
+		bool moveProxy(int32_t proxy, const AxisAlignedBoundingBox& bounds);
+
+		EntityHandle getEntity(int32_t proxy) const { return this->nodes[proxy].entity; };
+		const AxisAlignedBoundingBox& getBounds(int32_t proxy) const { return this->nodes[proxy].leaf_bounds; };
+
+		size_t size() const { return this->proxy_count; };
+		int32_t getHeight() const { return (this->root != null_node) ? this->nodes[this->root].height : 0; };
+		void clear();
+
+		//Visits every leaf whose box passes overlap, overlap(const AxisAlignedBoundingBox&) is tested against internal nodes too
+		//callback(EntityHandle entity, const AxisAlignedBoundingBox& bounds) returns false to stop early
+		template<typename Overlap, typename Callback>
+		void query(Overlap overlap, Callback callback) const
+		{
+			if (this->root == null_node)
+			{
+				return;
+			}
+
+			int32_t stack[max_stack_size];
+			size_t stack_size = 0;
+			stack[stack_size++] = this->root;
+
+			while (stack_size > 0)
+			{
+				const Node& node = this->nodes[stack[--stack_size]];
+				if (!overlap(node.bounds))
+				{
+					continue;
+				}
+
+				if (node.isLeaf())
+				{
+					if (overlap(node.leaf_bounds) && !callback(node.entity, node.leaf_bounds))
+					{
+						return;
+					}
+				}
+				else
+				{
+					GENESIS_ENGINE_ASSERT((stack_size + 2) <= max_stack_size, "DynamicAabbTree too deep");
+					stack[stack_size++] = node.child1;
+					stack[stack_size++] = node.child2;
+				}
+			}
+		};
+
+	protected:
+		//A balanced tree over a few billion leaves is still well under this
+		static constexpr size_t max_stack_size = 256;
+
+		struct Node
+		{
+			AxisAlignedBoundingBox bounds;
+			AxisAlignedBoundingBox leaf_bounds;
+			EntityHandle entity = null_entity;
+
+			//Next free node when the node is on the free list
+			int32_t parent = null_node;
+			int32_t child1 = null_node;
+			int32_t child2 = null_node;
+
+			//Leaves are 0, free nodes are -1
+			int32_t height = -1;
+
+			bool isLeaf() const { return this->child1 == null_node; };
+		};
+
+		int32_t allocateNode();
+		void freeNode(int32_t node);
+
+		void insertLeaf(int32_t leaf);
+		void removeLeaf(int32_t leaf);
+		int32_t balance(int32_t node);
+
+		vector<Node> nodes;
+		int32_t root = null_node;
+		int32_t free_list = null_node;
+		size_t proxy_count = 0;
+		float margin;
+	};
+}
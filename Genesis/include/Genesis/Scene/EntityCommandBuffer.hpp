@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Core/TypeInfo.hpp"
+
+namespace Genesis
+{
+	class JobSystem;
+
+	//An entity referenced by a command buffer, either one that already exists or one created earlier in the same buffer
+	struct CommandEntity
+	{
+		static constexpr uint32_t not_created = UINT32_MAX;
+
+		EntityHandle handle = null_entity;
+		uint32_t created_index = not_created;
+
+		CommandEntity() {};
+		CommandEntity(EntityHandle handle) { this->handle = handle; };
+	};
+
+	//Records structural changes so they can be made from any thread, then applied to the registry at a sync point
+	//A single buffer isn't thread safe, use EntityCommandBuffers to get one per thread
+	//Playback applies commands grouped by kind rather than in record order: creates, component adds, parent changes, component removes, destroys
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer() {};
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer(EntityCommandBuffer&&) = default;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(EntityCommandBuffer&&) = default;
+
+		//The entity is only created at playback, but can be used by later commands on this buffer
+		CommandEntity createEntity();
+		CommandEntity createEntity(const char* name);
+
+		//Destroys the entity and everything under it
+		void destroyEntity(CommandEntity entity);
+
+		template<typename T, typename... Args>
+		void addComponent(CommandEntity entity, Args&&... args)
+		{
+			ComponentCommands<T>& commands = this->getComponentCommands<T>();
+			commands.add_entities.push_back(entity);
+			commands.add_values.emplace_back(std::forward<Args>(args)...);
+		};
+
+		template<typename T>
+		void removeComponent(CommandEntity entity)
+		{
+			this->getComponentCommands<T>().remove_entities.push_back(entity);
+		};
+
+		void addChild(CommandEntity parent, CommandEntity child);
+		void removeChild(CommandEntity parent, CommandEntity child);
+
+		//Applies every command then clears the buffer, must be called on a thread that owns the scene
+		void playback(Scene* scene);
+
+		bool empty() const { return this->command_count == 0; };
+		void clear();
+
+	protected:
+		struct ComponentCommandsBase
+		{
+			virtual ~ComponentCommandsBase() {};
+			virtual void playbackAdds(EntityRegistry& registry, const vector<EntityHandle>& created_entities) = 0;
+			virtual void playbackRemoves(EntityRegistry& registry, const vector<EntityHandle>& created_entities) = 0;
+			virtual void clear() = 0;
+		};
+
+		template<typename T>
+		struct ComponentCommands : public ComponentCommandsBase
+		{
+			vector<CommandEntity> add_entities;
+			vector<T> add_values;
+			vector<CommandEntity> remove_entities;
+
+			virtual void playbackAdds(EntityRegistry& registry, const vector<EntityHandle>& created_entities) override
+			{
+				if (this->add_entities.empty())
+				{
+					return;
+				}
+
+				//One pool growth for the whole batch instead of one per insert
+				registry.reserve<T>(registry.size<T>() + this->add_entities.size());
+				for (size_t i = 0; i < this->add_entities.size(); i++)
+				{
+					EntityHandle entity = EntityCommandBuffer::resolve(this->add_entities[i], created_entities);
+					if (registry.valid(entity))
+					{
+						registry.assign_or_replace<T>(entity, std::move(this->add_values[i]));
+					}
+				}
+			};
+
+			virtual void playbackRemoves(EntityRegistry& registry, const vector<EntityHandle>& created_entities) override
+			{
+				for (CommandEntity command_entity : this->remove_entities)
+				{
+					EntityHandle entity = EntityCommandBuffer::resolve(command_entity, created_entities);
+					if (registry.valid(entity) && registry.has<T>(entity))
+					{
+						registry.remove<T>(entity);
+					}
+				}
+			};
+
+			virtual void clear() override
+			{
+				this->add_entities.clear();
+				this->add_values.clear();
+				this->remove_entities.clear();
+			};
+		};
+
+		struct ParentCommand
+		{
+			CommandEntity parent;
+			CommandEntity child;
+			bool add;
+		};
+
+		template<typename T>
+		ComponentCommands<T>& getComponentCommands()
+		{
+			this->command_count++;
+
+			const size_t type_hash = TypeInfo<T>::getHash();
+			auto iterator = this->component_command_index.find(type_hash);
+			if (iterator != this->component_command_index.end())
+			{
+				return *static_cast<ComponentCommands<T>*>(this->component_commands[iterator->second].get());
+			}
+
+			this->component_command_index[type_hash] = this->component_commands.size();
+			this->component_commands.push_back(std::make_unique<ComponentCommands<T>>());
+			return *static_cast<ComponentCommands<T>*>(this->component_commands.back().get());
+		};
+
+		static EntityHandle resolve(CommandEntity entity, const vector<EntityHandle>& created_entities);
+
+		size_t command_count = 0;
+		uint32_t created_count = 0;
+		vector<ParentCommand> parent_commands;
+		vector<CommandEntity> destroyed_entities;
+
+		//Kept between playbacks so the per type storage is only allocated once
+		flat_hash_map<size_t, size_t> component_command_index;
+		vector<std::unique_ptr<ComponentCommandsBase>> component_commands;
+
+		//Playback scratch, real handles for created_index
+		vector<EntityHandle> created_entities;
+	};
+
+	//One command buffer per JobSystem thread, so jobs can record without locking
+	class EntityCommandBuffers
+	{
+	public:
+		EntityCommandBuffers(JobSystem* job_system = nullptr);
+
+		//The buffer for the calling thread, only that thread may use it until playback
+		EntityCommandBuffer& get();
+
+		//Plays every thread's buffer back in thread order
+		void playback(Scene* scene);
+
+	protected:
+		JobSystem* job_system = nullptr;
+		vector<EntityCommandBuffer> buffers;
+	};
+}
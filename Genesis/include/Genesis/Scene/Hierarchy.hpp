@@ -7,6 +7,8 @@ namespace Genesis
 	struct ParentNode
 	{
 		EntityHandle first{ null_entity };
+		EntityHandle last{ null_entity };
+		uint32_t child_count = 0;
 	};
 
 	struct ChildNode
@@ -16,10 +18,34 @@ namespace Genesis
 		EntityHandle parent{ null_entity };
 	};
 
+	//Kept in the registry context, bumped whenever the shape of the hierarchy changes so cached traversals know to rebuild
+	struct HierarchyVersion
+	{
+		uint64_t version = 0;
+		uint64_t sorted_version = 0;
+	};
+
 	struct HierarchyUtils
 	{
+		//Both are constant time, a child that already has a parent is moved
 		static void addChild(EntityRegistry& registry, EntityHandle parent, EntityHandle child);
 		static void removeChild(EntityRegistry& registry, EntityHandle parent, EntityHandle child);
+
+		//Appends entity and everything under it to entities, parents always come before their children
+		static void getSubtree(EntityRegistry& registry, EntityHandle entity, vector<EntityHandle>& entities);
+
+		//Sorts the ChildNode pool so siblings are contiguous and subtrees are close together, making child iteration sequential in memory
+		//Sorting moves components around, so don't hold onto ChildNode references across it or call it while anything else uses the registry
+		static void sortDepthFirst(EntityRegistry& registry);
+
+		//Only sorts if the hierarchy changed at least min_changes times since the last sort, cheap enough to call every frame
+		static void sortDepthFirstIfNeeded(EntityRegistry& registry, uint64_t min_changes);
+
+		static void markChanged(EntityRegistry& registry);
+		static uint64_t getVersion(EntityRegistry& registry);
+
+		//Signature matches the registry's construct/destroy signals, so it can be connected for any component a cache depends on
+		static void onHierarchyChanged(EntityRegistry& registry, EntityHandle entity);
 	};
 
 	class HiearchyIterator
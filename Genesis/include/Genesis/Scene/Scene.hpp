@@ -25,10 +25,10 @@ namespace Genesis
 		void removeChild(Entity parent, Entity child);
 
 		SceneLightingSettings lighting_settings;
-		SceneRenderList render_list;
+		SceneRenderListBuffer render_lists;
 
-		// TODO
-		//EntityWorld* clone();
+		//Copy of every entity and registered component, see SceneSnapshot
+		Scene* clone();
 
 		//TODO figure out to do this better
 		void initialize_scene();
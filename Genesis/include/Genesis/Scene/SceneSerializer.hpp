@@ -2,9 +2,22 @@
 
 #include "Genesis/Scene/Scene.hpp"
 
+namespace YAML
+{
+	class Node;
+}
+
 namespace Genesis
 {
 	class ResourceManager;
+	class Entity;
+
+	//Single entity nodes, for files made up of entity lists like WorldPartition's cells
+	YAML::Node serializeEntity(Entity entity);
+	Entity deserializeEntity(YAML::Node& entity_node, Scene* scene, ResourceManager* resource_manager);
+
+	//Mesh and material names an entity node and its children use, doesn't touch the resource pools so it's safe on any thread
+	void getEntityResources(const YAML::Node& entity_node, vector<string>& mesh_names, vector<string>& material_names);
 
 	//typedef void(*EntitySerializeFunction)(Entity, void*);
 	//typedef void(*EntityDeserializeFunction)(Entity, void*);
@@ -16,6 +29,10 @@ namespace Genesis
 		void serialize(Scene* scene, const char* file_path);
 		Scene* deserialize(const char* file_path, ResourceManager* resource_manager);
 
+		//A single entity and everything under it, the format prefabs are loaded from
+		void serializeEntity(Entity entity, const char* file_path);
+		Entity deserializeEntity(const char* file_path, Scene* scene, ResourceManager* resource_manager);
+
 		//void addSerializeFuncions(EntitySerializeFunction serialize, EntityDeserializeFunction deserialize);
 	protected:
 		//vector<EntitySerializeFunction> serialize_functions;
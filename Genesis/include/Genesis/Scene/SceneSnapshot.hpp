@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Core/TypeInfo.hpp"
+
+namespace Genesis
+{
+	//Pool level copies of a whole scene, entity handles are kept so hierarchy links and anything else holding handles stay valid
+	//Much faster than a SceneSerializer round trip, used for play in editor and rollback
+	class SceneSnapshot
+	{
+	public:
+		typedef void(*CopyFunction)(EntityRegistry& source, EntityRegistry& destination);
+
+		//Only registered component types are copied, the engine's own components are registered already
+		//Trivially copyable components are copied a whole pool at a time, anything else is copy constructed per entity
+		template<typename T>
+		static void registerComponent()
+		{
+			SceneSnapshot::registerComponent(TypeInfo<T>::getHash(), &SceneSnapshot::copyPool<T>);
+		};
+
+		//For components that own something that can't be shared between scenes, eg physics bodies
+		//Registering the same type again replaces its copy function
+		static void registerComponent(size_t type_hash, CopyFunction copy_function);
+
+		//Replaces everything in destination with a copy of source
+		static void copyScene(Scene* source, Scene* destination);
+
+		//Keeps a copy of scene, which can be written back over it later
+		void capture(Scene* scene);
+		void restore(Scene* scene);
+		bool empty() const { return !this->snapshot; };
+		void clear() { this->snapshot.reset(); };
+
+		template<typename T>
+		static void copyPool(EntityRegistry& source, EntityRegistry& destination)
+		{
+			auto view = source.view<T>();
+			if (view.empty())
+			{
+				return;
+			}
+
+			const EntityHandle* entities = view.data();
+			if constexpr (std::is_empty_v<T>)
+			{
+				destination.insert<T>(entities, entities + view.size());
+			}
+			else if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				//Packed pool straight into packed pool, which comes down to a memcpy
+				const T* components = view.raw();
+				destination.insert<T>(entities, entities + view.size(), components, components + view.size());
+			}
+			else
+			{
+				destination.reserve<T>(view.size());
+				for (EntityHandle entity : view)
+				{
+					destination.emplace<T>(entity, view.get(entity));
+				}
+			}
+		};
+
+	protected:
+		std::unique_ptr<Scene> snapshot;
+	};
+}
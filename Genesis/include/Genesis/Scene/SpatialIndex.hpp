@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Genesis/Scene/DynamicAabbTree.hpp"
+#include "Genesis/Rendering/Frustum.hpp"
+
+namespace Genesis
+{
+	//World space bounds of every model in a scene, kept in SceneComponents and updated by SpatialIndexSystem
+	//Queries are read only and safe to run concurrently, but not while SpatialIndexSystem is running
+	class SpatialIndex
+	{
+	public:
+		void insertOrUpdate(EntityHandle entity, const AxisAlignedBoundingBox& bounds);
+		void remove(EntityHandle entity);
+		bool contains(EntityHandle entity) const { return this->proxies.find(entity) != this->proxies.end(); };
+
+		size_t size() const { return this->tree.size(); };
+		void clear();
+
+		//All of these append to results rather than clearing it
+		void queryAabb(const AxisAlignedBoundingBox& bounds, vector<EntityHandle>& results) const;
+		void querySphere(const vector3F& center, float radius, vector<EntityHandle>& results) const;
+		void queryFrustum(const Frustum& frustum, vector<EntityHandle>& results) const;
+
+		//Entities whose bounds the ray passes through, nearest first
+		void raycast(const vector3F& origin, const vector3F& direction, float max_distance, vector<EntityHandle>& results) const;
+
+		const DynamicAabbTree& getTree() const { return this->tree; };
+
+	protected:
+		DynamicAabbTree tree;
+		flat_hash_map<EntityHandle, int32_t> proxies;
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Job/JobSystem.hpp"
+
+namespace Genesis
+{
+	class ResourceManager;
+
+	//Splits a world into square cells on the XZ plane, each saved to its own file and only kept in the scene while it's near the focus
+	//Cell files, and any meshes, materials and textures they use that aren't loaded yet, are read and parsed on Background jobs
+	//The GPU uploads and entity creation are then spread across frames on the main thread, so streaming never stalls a frame
+	//World files list the cells, root entities without a Transform and the lighting settings, those are always loaded
+	class WorldPartition
+	{
+	public:
+		//Writes every root entity of the scene to the cell its position falls in, cell files are written next to the world file
+		static void save(Scene* scene, const char* file_path, double cell_size);
+
+		//Loads the world file into the scene, cells are streamed in by update
+		//job_system may be null, cells are then parsed on the main thread
+		WorldPartition(const char* file_path, Scene* scene, ResourceManager* resource_manager, JobSystem* job_system);
+
+		//Waits on any cell still being parsed, entities already in the scene are left there
+		~WorldPartition();
+
+		//Main thread only, and only while nothing else is using the registry since it creates and destroys entities
+		void update(const vector3D& focus_position);
+
+		//Cells with a center within load_radius are loaded, loaded cells are only dropped once past unload_radius
+		double load_radius = 256.0;
+		double unload_radius = 320.0;
+
+		//Time update may spend uploading resources and creating and destroying entities each frame, at least one resource or root entity is always done
+		double frame_budget_ms = 2.0;
+
+		double getCellSize() const { return this->cell_size; };
+		size_t getCellCount() const { return this->cells.size(); };
+		size_t getLoadedCellCount() const { return this->loaded_cell_count; };
+		size_t getPendingCellCount() const { return this->resident_cells.size() - this->loaded_cell_count; };
+
+	protected:
+		//Defined in WorldPartition.cpp, it holds the parsed file
+		struct Cell;
+
+		struct CellHash
+		{
+			size_t operator()(const vector2I& coord) const
+			{
+				return std::hash<int64_t>()(((int64_t)coord.x << 32) | (uint32_t)coord.y);
+			};
+		};
+
+		vector2I getCellCoord(const vector3D& position) const;
+		double getCellDistance(const Cell& cell, const vector3D& position) const;
+
+		void loadCell(Cell& cell);
+		void unloadCell(Cell& cell);
+
+		//Once parsed, starts the job that reads the resources the cell uses that aren't loaded yet
+		void readCellResources(Cell& cell);
+
+		//Returns false once the time budget is used up
+		bool uploadCellResources(Cell& cell, std::chrono::high_resolution_clock::time_point end_time);
+
+		//Returns false once the time budget is used up
+		bool instantiateCell(Cell& cell, std::chrono::high_resolution_clock::time_point end_time);
+
+		Scene* scene;
+		ResourceManager* resource_manager;
+		JobSystem* job_system;
+
+		double cell_size = 0.0;
+		flat_hash_map<vector2I, std::unique_ptr<Cell>, CellHash> cells;
+
+		//Cells that are loading, loaded or waiting to finish loading so they can be dropped, closest first after each update
+		vector<Cell*> resident_cells;
+		size_t loaded_cell_count = 0;
+
+		//Roots of unloaded cells that haven't been destroyed yet
+		vector<EntityHandle> pending_destroy;
+
+		//Counts the cell parse and resource read jobs still running
+		JobCounter parse_counter{ 0 };
+	};
+}
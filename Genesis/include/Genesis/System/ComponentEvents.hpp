@@ -1,24 +1,129 @@
 #pragma once
 
-#include "entt/core/type_info.hpp"
-#include "Genesis/Ecs/EntityWorld.hpp"
-#include "Genesis/Component/TransformComponent.hpp"
+#include "Genesis/Scene/Ecs.hpp"
+
 namespace Genesis
 {
-	typedef void(*EntityOnEnabledFunction)(EntityWorld*, EntityHandle, const Transform&, EntityHandle);
-	typedef void(*EntityOnDisabledFunction)(EntityWorld*, EntityHandle, EntityHandle);
+	//Entities whose T was constructed, updated or destroyed since the change sets were last cleared
+	//Each entity is listed at most once per list, but can be in more than one, eg constructed then destroyed in the same frame
+	template<typename T>
+	struct ComponentChanges
+	{
+		vector<EntityHandle> constructed;
+		vector<EntityHandle> updated;
+		vector<EntityHandle> destroyed;
+
+		bool empty() const
+		{
+			return this->constructed.empty() && this->updated.empty() && this->destroyed.empty();
+		};
+
+		void clear()
+		{
+			this->constructed.clear();
+			this->updated.clear();
+			this->destroyed.clear();
+			this->listed.clear();
+		};
+
+		void add(vector<EntityHandle>& list, uint8_t list_bit, EntityHandle entity)
+		{
+			uint8_t& bits = this->listed[entity];
+			if ((bits & list_bit) == 0)
+			{
+				bits |= list_bit;
+				list.push_back(entity);
+			}
+		};
+
+		static constexpr uint8_t constructed_bit = 1 << 0;
+		static constexpr uint8_t updated_bit = 1 << 1;
+		static constexpr uint8_t destroyed_bit = 1 << 2;
+
+	protected:
+		flat_hash_map<EntityHandle, uint8_t> listed;
+	};
+
+	//Every observed type in a registry, so all of its change sets can be cleared at once
+	struct ComponentEventsContext
+	{
+		vector<void(*)(EntityRegistry&)> clear_functions;
+	};
 
+	//Reactive layer over the registry's signals, systems observe the component types they care about and then only process what changed
+	//Change sets live in the registry context and are filled from the signals, so like any structural change they aren't thread safe
+	//Call clearChanges once per frame after every system that reads them has run
 	class ComponentEvents
 	{
+	public:
+		//Safe to call every frame, only the first call for a registry connects anything
+		//Changes made before a type is observed are never seen, so anything observing should do a full pass the first time
+		template<typename T>
+		static void observe(EntityRegistry& registry)
+		{
+			if (registry.try_ctx<ComponentChanges<T>>() != nullptr)
+			{
+				return;
+			}
+
+			registry.set<ComponentChanges<T>>();
+			registry.on_construct<T>().template connect<&ComponentEvents::onConstruct<T>>();
+			registry.on_replace<T>().template connect<&ComponentEvents::onUpdate<T>>();
+			registry.on_destroy<T>().template connect<&ComponentEvents::onDestroy<T>>();
+			registry.ctx_or_set<ComponentEventsContext>().clear_functions.push_back(&ComponentEvents::clearChanges<T>);
+		};
+
+		//nullptr if T isn't observed in this registry
+		template<typename T>
+		static const ComponentChanges<T>* getChanges(EntityRegistry& registry)
+		{
+			return registry.try_ctx<ComponentChanges<T>>();
+		};
+
+		//Writes through get<T>() don't fire a signal, so anything that edits in place has to report it
+		template<typename T>
+		static void markUpdated(EntityRegistry& registry, EntityHandle entity)
+		{
+			ComponentChanges<T>* changes = registry.try_ctx<ComponentChanges<T>>();
+			if (changes != nullptr)
+			{
+				changes->add(changes->updated, ComponentChanges<T>::updated_bit, entity);
+			}
+		};
+
+		template<typename T>
+		static void clearChanges(EntityRegistry& registry)
+		{
+			ComponentChanges<T>* changes = registry.try_ctx<ComponentChanges<T>>();
+			if (changes != nullptr)
+			{
+				changes->clear();
+			}
+		};
+
+		//Clears the change sets of every observed type
+		static void clearChanges(EntityRegistry& registry);
+
 	protected:
-		flat_hash_map<ENTT_ID_TYPE, EntityOnEnabledFunction> on_enabled_functions;
-		flat_hash_map<ENTT_ID_TYPE, EntityOnDisabledFunction> on_disabled_functions;
+		template<typename T>
+		static void onConstruct(EntityRegistry& registry, EntityHandle entity)
+		{
+			ComponentChanges<T>& changes = registry.ctx<ComponentChanges<T>>();
+			changes.add(changes.constructed, ComponentChanges<T>::constructed_bit, entity);
+		};
 
-	public:
-		void add_enable_function(ENTT_ID_TYPE component_id, EntityOnEnabledFunction enabled_function) {};
-		void add_disabled_function(ENTT_ID_TYPE component_id, EntityOnDisabledFunction disabled_function) {};
+		template<typename T>
+		static void onUpdate(EntityRegistry& registry, EntityHandle entity)
+		{
+			ComponentChanges<T>& changes = registry.ctx<ComponentChanges<T>>();
+			changes.add(changes.updated, ComponentChanges<T>::updated_bit, entity);
+		};
 
-		void on_enabled(ENTT_ID_TYPE component_id, EntityWorld* world, EntityHandle root, const Transform& relative_transform, EntityHandle entity) {};
-		void on_disabled(ENTT_ID_TYPE component_id, EntityWorld* world, EntityHandle root, const Transform& relative_transform, EntityHandle entity) {};
+		template<typename T>
+		static void onDestroy(EntityRegistry& registry, EntityHandle entity)
+		{
+			ComponentChanges<T>& changes = registry.ctx<ComponentChanges<T>>();
+			changes.add(changes.destroyed, ComponentChanges<T>::destroyed_bit, entity);
+		};
 	};
-}
\ No newline at end of file
+}
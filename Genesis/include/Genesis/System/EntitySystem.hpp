@@ -1,12 +1,126 @@
 #pragma once
 
 #include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Core/TypeInfo.hpp"
+
+//Checked component accessors in EntitySystem assert on any component the system didn't declare
+#ifdef GENESIS_ASSERT_ENABLED
+#define GENESIS_ENTITY_SYSTEM_ACCESS_CHECKS
+#endif
 
 namespace Genesis
 {
+	//Component types a system touches, as TypeInfo hashes
+	//A system that declares nothing is exclusive, it is assumed to touch everything and never runs alongside another system
+	struct ComponentAccess
+	{
+		vector<size_t> reads;
+		vector<size_t> writes;
+		bool exclusive = true;
+
+		//Creates or destroys entities, or adds or removes components, directly on the registry
+		bool structural = false;
+
+		bool canRead(size_t type_hash) const;
+		bool canWrite(size_t type_hash) const;
+
+		//True if the two can't run at the same time, ie either one writes something the other reads or writes, or either one is structural
+		bool conflictsWith(const ComponentAccess& other) const;
+	};
+
 	class EntitySystem
 	{
 	public:
+		virtual ~EntitySystem() {};
+
+		//Called at a sync point where nothing else is using the registry, before the first run and whenever the registry may have been replaced
+		//Structural work the system needs, like observing components or adding scene components, goes here so run can leave the registry's structure alone
+		//Has to be safe to call every frame
+		virtual void setup(Scene* scene) {};
+
 		virtual void run(Scene* scene, const TimeStep time_step) = 0;
+
+		const ComponentAccess& getAccess() const { return this->access; };
+
+	protected:
+		//Call from the constructor, registry context data counts as a component
+		//Creating or destroying entities, or adding and removing components, has to be declared with writesStructure or recorded into an EntityCommandBuffer
+		//In debug builds the declarations are only checked for access through the accessors below, direct registry calls and static helpers like TransformResolveSystem::getWorldTransform go unchecked
+		template<typename... Components>
+		void reads()
+		{
+			this->access.exclusive = false;
+			(this->access.reads.push_back(TypeInfo<Components>::getHash()), ...);
+		};
+
+		template<typename... Components>
+		void writes()
+		{
+			this->access.exclusive = false;
+			(this->access.writes.push_back(TypeInfo<Components>::getHash()), ...);
+		};
+
+		//Structural changes can invalidate any view or component reference, so the system never runs alongside another one
+		void writesStructure()
+		{
+			this->access.exclusive = false;
+			this->access.structural = true;
+		};
+
+		//Checked accessors, these only catch access that goes through them, not direct registry calls
+		template<typename Component>
+		const Component& readComponent(EntityRegistry& registry, EntityHandle entity) const
+		{
+			this->checkRead<Component>();
+			return registry.get<Component>(entity);
+		};
+
+		template<typename Component>
+		const Component* tryReadComponent(EntityRegistry& registry, EntityHandle entity) const
+		{
+			this->checkRead<Component>();
+			return registry.try_get<Component>(entity);
+		};
+
+		template<typename Component>
+		Component& writeComponent(EntityRegistry& registry, EntityHandle entity) const
+		{
+			this->checkWrite<Component>();
+			return registry.get<Component>(entity);
+		};
+
+		template<typename Component>
+		Component* tryWriteComponent(EntityRegistry& registry, EntityHandle entity) const
+		{
+			this->checkWrite<Component>();
+			return registry.try_get<Component>(entity);
+		};
+
+		template<typename... Components, typename... Exclude>
+		auto viewComponents(EntityRegistry& registry, entt::exclude_t<Exclude...> exclude = {}) const
+		{
+			(this->checkRead<Components>(), ...);
+			(this->checkRead<Exclude>(), ...);
+			return registry.view<Components...>(exclude);
+		};
+
+		template<typename Component>
+		void checkRead() const
+		{
+#ifdef GENESIS_ENTITY_SYSTEM_ACCESS_CHECKS
+			GENESIS_ENGINE_ASSERT(this->access.canRead(TypeInfo<Component>::getHash()), "EntitySystem read a component it didn't declare");
+#endif
+		};
+
+		template<typename Component>
+		void checkWrite() const
+		{
+#ifdef GENESIS_ENTITY_SYSTEM_ACCESS_CHECKS
+			GENESIS_ENGINE_ASSERT(this->access.canWrite(TypeInfo<Component>::getHash()), "EntitySystem wrote a component it didn't declare");
+#endif
+		};
+
+	private:
+		ComponentAccess access;
 	};
-}
\ No newline at end of file
+}
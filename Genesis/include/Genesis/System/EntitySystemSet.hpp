@@ -2,22 +2,44 @@
 
 #include "Genesis/Scene/Ecs.hpp"
 #include "Genesis/System/EntitySystem.hpp"
+#include "Genesis/Job/TaskGraph.hpp"
 
 namespace Genesis
 {
+	//Runs systems in insertion order, except that systems whose declared component access doesn't conflict run concurrently
+	//Conflicting systems keep their insertion order, so the results are the same as running everything serially
 	class EntitySystemSet
 	{
 	public:
-		void add_system(EntitySystem* system) { this->systems.push_back(system); };
-		void run_systems(Scene* scene, const TimeStep time_step)
+		EntitySystemSet(JobSystem* job_system = nullptr)
 		{
-			for (auto system : this->systems)
-			{
-				system->run(scene, time_step);
-			}
+			this->job_system = job_system;
 		};
 
+		void add_system(EntitySystem* system)
+		{
+			this->systems.push_back(system);
+			this->schedule.reset();
+		};
+
+		//Calls setup on every system, only at a sync point where nothing else is using the registry
+		void setup_systems(Scene* scene);
+
+		//Blocks until every system has finished, safe to call from a job as long as no system needs the main thread
+		void run_systems(Scene* scene, const TimeStep time_step);
+
+		//Timings and critical path of the last run, empty if the set was run serially
+		string dump();
+
 	protected:
+		void buildSchedule();
+
+		JobSystem* job_system = nullptr;
 		vector<EntitySystem*> systems;
+
+		//Rebuilt when a system is added, each system is a node with an edge from every earlier system it conflicts with
+		std::unique_ptr<TaskGraph> schedule;
+		Scene* run_scene = nullptr;
+		TimeStep run_time_step = 0.0;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Genesis/System/EntitySystem.hpp"
+#include "Genesis/Job/JobSystem.hpp"
+
+namespace Genesis
+{
+	//Builds the scene's next render list with buildSceneRenderList, run it after TransformResolveSystem
+	//Only reads the registry, the list it writes belongs to the scene rather than any component
+	class RenderListSystem : public EntitySystem
+	{
+	public:
+		//Extraction is split across the job system when one is given
+		RenderListSystem(JobSystem* job_system = nullptr);
+
+		virtual void run(Scene* scene, const TimeStep time_step);
+
+	protected:
+		JobSystem* job_system = nullptr;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Genesis/Scene/SpatialIndex.hpp"
+#include "Genesis/System/EntitySystem.hpp"
+#include "Genesis/System/ComponentEvents.hpp"
+
+namespace Genesis
+{
+	//Keeps the scene's SpatialIndex in sync with every ModelComponent, run it after TransformResolveSystem
+	//Only entities whose transform was resolved last run, or whose model changed this frame, are touched
+	//Model changes come from ComponentEvents, so the change sets have to be cleared once per frame after this runs
+	class SpatialIndexSystem : public EntitySystem
+	{
+	public:
+		SpatialIndexSystem();
+
+		//Observes the components and adds the scene's SpatialIndex, run does nothing until this has been called for the scene
+		virtual void setup(Scene* scene);
+
+		virtual void run(Scene* scene, const TimeStep time_step);
+
+		//For changes the system can't see, eg swapping the mesh on an existing ModelComponent
+		static void markChanged(EntityRegistry& registry, EntityHandle entity);
+
+		//Mesh bounds moved into world space, false if the entity has no model or isn't in the transform hierarchy
+		static bool getWorldBounds(EntityRegistry& registry, EntityHandle entity, AxisAlignedBoundingBox& bounds);
+
+	protected:
+		//Set by setup when it had to start from nothing, the next run does a full pass
+		bool rebuild_pending = true;
+	};
+}
@@ -1,74 +1,107 @@
 #pragma once
 
 #include "Genesis/Component/TransformComponent.hpp"
+#include "Genesis/Core/TransformBatch.hpp"
 #include "Genesis/Scene/Ecs.hpp"
 #include "Genesis/Scene/Hierarchy.hpp"
 #include "Genesis/System/EntitySystem.hpp"
+#include "Genesis/Job/JobSystem.hpp"
 
 namespace Genesis
 {
+	//The transform hierarchy flattened into depth order, kept in the registry context so it follows the scene around
+	//Trees are appended in batches, a full build is one batch and each streaming update that adds whole trees appends another
+	//Within a batch every parent is in an earlier level than its children and siblings are contiguous, so each level can be resolved in one pass over the level before it
+	struct TransformHierarchyCache
+	{
+		static constexpr uint32_t no_parent = UINT32_MAX;
+
+		uint64_t version = 0;
+		bool valid = false;
+
+		vector<EntityHandle> entities;
+		vector<uint32_t> parent_index;
+
+		//Levels of the last appended batch, level n is [level_offsets[n], level_offsets[n + 1])
+		vector<size_t> level_offsets;
+
+		//Children of node i are [child_begin[i], child_end[i])
+		vector<uint32_t> child_begin;
+		vector<uint32_t> child_end;
+		vector<uint32_t> node_level;
+
+		//Index of the root of the tree each node is in
+		vector<uint32_t> root_index;
+		flat_hash_map<EntityHandle, uint32_t> entity_index;
+
+		//Destroyed subtrees are left in place with a null entity until there are enough of them to be worth a rebuild
+		size_t dead_count = 0;
+
+		//Recorded by the registry signals since the last run, so whole trees coming and going don't need a rebuild
+		vector<EntityHandle> added_entities;
+		vector<EntityHandle> removed_entities;
+		vector<EntityHandle> new_roots;
+
+		//Local transforms gathered from the components, then the resolved results, all indexed the same as entities
+		TransformBatchD local_batch;
+		TransformBatchD root_transforms;
+		TransformBatchD world_transforms;
+
+		//Incremental resolve scratch, dirty nodes are bucketed by level so parents are always done first
+		vector<uint8_t> dirty_marks;
+		vector<vector<uint32_t>> level_dirty_nodes;
+
+		//Every node resolved by the last run, in resolve order
+		vector<uint32_t> changed_nodes;
+		vector<EntityHandle> changed_entities;
+	};
+
 	class TransformResolveSystem: public EntitySystem
 	{
 	public:
-		virtual void run(Scene* scene, const TimeStep time_step)
+		//Each level is split across the job system when one is given
+		TransformResolveSystem(JobSystem* job_system = nullptr)
 		{
-			EntityRegistry& registry = scene->registry;
-			auto view = registry.view<Transform>(entt::exclude_t<ChildNode>());
-			for (auto entity : view)
-			{
-				Transforms transforms;
-
-				TransformD local_transform = registry.get<Transform>(entity);
-				transforms.root_transform.setScale(local_transform.getScale()); //Root transform only gets the scale of the root object
-				TransformUtils::transformByInplace(transforms.world_transform, transforms.world_transform, local_transform);
-
-				if (registry.has<RootTransform>(entity))
-				{
-					registry.get<RootTransform>(entity).setTransform(transforms.root_transform);
-				}
-
-				if (registry.has<WorldTransform>(entity))
-				{
-					registry.get<WorldTransform>(entity).setTransform(transforms.world_transform);
-				}
-
-				for (EntityHandle child : EntityHiearchy(&registry, entity))
-				{
-					this->resolveTransformChild(registry, child, transforms);
-				}
-			}
+			this->job_system = job_system;
+
+			//The cache and hierarchy version live in the registry context, so they count as components here
+			this->reads<ParentNode, ChildNode, Transform, HierarchyVersion>();
+			this->writes<RootTransform, WorldTransform, TransformDirty, TransformHierarchyCache>();
+
+			//Clears every TransformDirty, and the first run for a registry sets up the cache and connects its signals
+			this->writesStructure();
 		};
 
+		//Only subtrees under an entity marked dirty and trees added since the last run are resolved
+		//Everything is rebuilt and resolved if an existing entity moved to a new parent
+		virtual void run(Scene* scene, const TimeStep time_step);
+
+		//Call after writing an entity's local Transform, adding or removing a Transform marks it on its own
+		static void markDirty(EntityRegistry& registry, EntityHandle entity);
+
+		//Entities whose RootTransform/WorldTransform were resolved by the last run, for anything that mirrors transforms eg culling or physics
+		static const vector<EntityHandle>& getChangedEntities(EntityRegistry& registry);
+
+		//World transform from the last run, works for every entity in the hierarchy even without a WorldTransform component
+		static bool getWorldTransform(EntityRegistry& registry, EntityHandle entity, Transform& world_transform);
+
 	private:
-		struct Transforms
-		{
-			Transform world_transform;
-			Transform root_transform;
-		};
+		JobSystem* job_system = nullptr;
 
-		void resolveTransformChild(EntityRegistry& registry, EntityHandle entity, Transforms transforms)
-		{
-			if (registry.has<Transform>(entity))
-			{
-				Transform local_transform = registry.get<Transform>(entity);
-				TransformUtils::transformByInplace(transforms.root_transform, transforms.root_transform, local_transform);
-				TransformUtils::transformByInplace(transforms.world_transform, transforms.world_transform, local_transform);
-			}
-
-			if (registry.has<RootTransform>(entity))
-			{
-				registry.get<RootTransform>(entity).setTransform(transforms.root_transform);
-			}
-
-			if (registry.has<WorldTransform>(entity))
-			{
-				registry.get<WorldTransform>(entity).setTransform(transforms.world_transform);
-			}
-
-			for (EntityHandle child : EntityHiearchy(&registry, entity))
-			{
-				this->resolveTransformChild(registry, child, transforms);
-			}
-		}
+		static void onNodeAdded(EntityRegistry& registry, EntityHandle entity);
+		static void onNodeRemoved(EntityRegistry& registry, EntityHandle entity);
+
+		TransformHierarchyCache& getCache(EntityRegistry& registry);
+		void buildCache(EntityRegistry& registry, TransformHierarchyCache& cache);
+
+		//Applies what the signals recorded, returns false if the cache has to be rebuilt instead
+		bool updateCache(EntityRegistry& registry, TransformHierarchyCache& cache);
+
+		//Appends the trees under roots as one batch
+		void appendTrees(EntityRegistry& registry, TransformHierarchyCache& cache, const vector<EntityHandle>& roots);
+
+		void resolveLevels(EntityRegistry& registry, TransformHierarchyCache& cache);
+		void resolveDirty(EntityRegistry& registry, TransformHierarchyCache& cache);
+		void resolveRange(EntityRegistry& registry, TransformHierarchyCache& cache, size_t begin, size_t end);
 	};
-}
\ No newline at end of file
+}
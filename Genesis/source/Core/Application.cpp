@@ -6,11 +6,16 @@
 #include "Genesis/Platform/Window.hpp"
 #include "Genesis/RenderingBackend/RenderingBackend.hpp"
 
+#include <thread>
+
+//Time left before a frame is due where the limiter stops sleeping and spins instead, in seconds
+#define frame_limiter_spin_time 0.002
+
 namespace Genesis 
 {
 	Application::Application()
 	{
-		//this->job_system = new JobSystem();
+		this->job_system = new JobSystem();
 		this->input_manager = new InputManager("");
 	}
 
@@ -53,16 +58,68 @@ namespace Genesis
 		auto time_last_frame = time_last;
 		size_t frames = 0;
 
+		auto next_frame_time = time_last;
+
 		while (this->isRunning())
 		{
 			GENESIS_PROFILE_BLOCK_START("Application_Loop");
 
+			//No frame job from the last frame is still running, so its job payloads can be dropped
+			//Then pick up any GL work that was handed to the main thread by jobs since the last frame
+			//With a single job thread this is also where background jobs make progress, one per frame
+			if (this->job_system != nullptr)
+			{
+				this->job_system->getFrameArena().reset();
+				this->job_system->runMainThreadJobs();
+				this->job_system->runBackgroundJob();
+			}
+
 			time_current = clock::now();
 			TimeStep time_step = (TimeStep)std::chrono::duration_cast<std::chrono::duration<double>>(time_current - time_last).count();
 
 			this->update(time_step);
 
-			this->render(time_step);
+			//Whole fixed steps are taken out of the accumulator, the remainder is what gets interpolated
+			const TimeStep fixed_time_step = this->getFixedTimeStep();
+			this->fixed_time_accumulator += time_step;
+			uint32_t fixed_steps = (uint32_t)(this->fixed_time_accumulator / fixed_time_step);
+			if (fixed_steps > this->max_catch_up_steps)
+			{
+				fixed_steps = this->max_catch_up_steps;
+				this->fixed_time_accumulator = std::fmod(this->fixed_time_accumulator, fixed_time_step) + (fixed_steps * fixed_time_step);
+			}
+			this->fixed_time_accumulator -= fixed_steps * fixed_time_step;
+			this->interpolation_value = this->fixed_time_accumulator / fixed_time_step;
+
+			auto run_simulate = [this, time_step, fixed_time_step, fixed_steps]()
+			{
+				for (uint32_t i = 0; i < fixed_steps; i++)
+				{
+					this->fixedUpdate(fixed_time_step);
+				}
+
+				this->simulate(time_step);
+			};
+
+			if (this->job_system != nullptr)
+			{
+				JobCounter simulate_counter{ 0 };
+				this->job_system->addJob([&run_simulate](uint32_t thread_id)
+				{
+					run_simulate();
+				}, &simulate_counter, JobPriority::Critical);
+
+				this->render(this->interpolation_value);
+
+				this->job_system->waitForCounter(simulate_counter);
+			}
+			else
+			{
+				run_simulate();
+				this->render(this->interpolation_value);
+			}
+
+			this->finishFrame();
 
 			time_last = time_current;
 
@@ -74,11 +131,48 @@ namespace Genesis
 				time_last_frame = time_last;
 			}
 
+			if (this->frame_rate_limit > 0.0)
+			{
+				this->limitFrameRate(next_frame_time);
+			}
+
 			GENESIS_PROFILE_BLOCK_END();
 		}
 
 	}
 
+	void Application::limitFrameRate(std::chrono::high_resolution_clock::time_point& next_frame_time)
+	{
+		GENESIS_PROFILE_FUNCTION("Application::limitFrameRate");
+
+		using clock = std::chrono::high_resolution_clock;
+		const clock::duration frame_time = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / this->frame_rate_limit));
+		const clock::duration spin_time = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(frame_limiter_spin_time));
+
+		//Frames are scheduled off the last deadline rather than the current time so sleep overshoot doesn't add up
+		//If a frame ran long enough to miss its slot entirely the schedule starts over instead of rushing to catch up
+		next_frame_time += frame_time;
+		clock::time_point now = clock::now();
+		if (now >= next_frame_time)
+		{
+			if ((now - next_frame_time) > frame_time)
+			{
+				next_frame_time = now;
+			}
+			return;
+		}
+
+		if ((next_frame_time - now) > spin_time)
+		{
+			std::this_thread::sleep_for(next_frame_time - now - spin_time);
+		}
+
+		while (clock::now() < next_frame_time)
+		{
+			std::this_thread::yield();
+		}
+	}
+
 	void Application::update(TimeStep time_step)
 	{
 		GENESIS_PROFILE_FUNCTION("Application::update");
@@ -95,11 +189,25 @@ namespace Genesis
 	}
 
 
-	void Application::render(TimeStep time_step)
+	void Application::fixedUpdate(TimeStep fixed_time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("Application::fixedUpdate");
+	}
+
+	void Application::simulate(TimeStep time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("Application::simulate");
+	}
+
+	void Application::render(TimeStep interpolation_value)
 	{
 		GENESIS_PROFILE_FUNCTION("Application::render");
 	}
 
+	void Application::finishFrame()
+	{
+	}
+
 	void Application::close()
 	{
 		this->is_running = false;
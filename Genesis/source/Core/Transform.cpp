@@ -134,6 +134,15 @@ namespace Genesis
 		destination.setScale(global.getScale() / origin.getScale());
 	}
 
+	TransformD TransformUtils::interpolate(const TransformD& first, const TransformD& second, double alpha)
+	{
+		TransformD transform;
+		transform.setPosition(glm::mix(first.getPosition(), second.getPosition(), alpha));
+		transform.setOrientation(glm::slerp(first.getOrientation(), second.getOrientation(), alpha));
+		transform.setScale(glm::mix(first.getScale(), second.getScale(), alpha));
+		return transform;
+	}
+
 	TransformD TransformUtils::toTransformD(const TransformF& transform)
 	{
 		return TransformD((vector3D) transform.getPosition(), (quaternionD) transform.getOrientation(), (vector3D) transform.getScale());
@@ -0,0 +1,314 @@
+#include "Genesis/Core/TransformBatch.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GENESIS_TRANSFORM_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GENESIS_TRANSFORM_BATCH_SSE2
+#endif
+
+namespace Genesis
+{
+	void TransformBatchD::resize(size_t size)
+	{
+		this->position_x.resize(size);
+		this->position_y.resize(size);
+		this->position_z.resize(size);
+		this->orientation_x.resize(size);
+		this->orientation_y.resize(size);
+		this->orientation_z.resize(size);
+		this->orientation_w.resize(size);
+		this->scale_x.resize(size);
+		this->scale_y.resize(size);
+		this->scale_z.resize(size);
+	}
+
+	void TransformBatchD::set(size_t index, const TransformD& transform)
+	{
+		vector3D position = transform.getPosition();
+		quaternionD orientation = transform.getOrientation();
+		vector3D scale = transform.getScale();
+
+		this->position_x[index] = position.x;
+		this->position_y[index] = position.y;
+		this->position_z[index] = position.z;
+		this->orientation_x[index] = orientation.x;
+		this->orientation_y[index] = orientation.y;
+		this->orientation_z[index] = orientation.z;
+		this->orientation_w[index] = orientation.w;
+		this->scale_x[index] = scale.x;
+		this->scale_y[index] = scale.y;
+		this->scale_z[index] = scale.z;
+	}
+
+	void TransformBatchD::setIdentity(size_t index)
+	{
+		this->position_x[index] = 0.0;
+		this->position_y[index] = 0.0;
+		this->position_z[index] = 0.0;
+		this->orientation_x[index] = 0.0;
+		this->orientation_y[index] = 0.0;
+		this->orientation_z[index] = 0.0;
+		this->orientation_w[index] = 1.0;
+		this->scale_x[index] = 1.0;
+		this->scale_y[index] = 1.0;
+		this->scale_z[index] = 1.0;
+	}
+
+	TransformD TransformBatchD::get(size_t index) const
+	{
+		return TransformD(
+			vector3D(this->position_x[index], this->position_y[index], this->position_z[index]),
+			quaternionD(this->orientation_w[index], this->orientation_x[index], this->orientation_y[index], this->orientation_z[index]),
+			vector3D(this->scale_x[index], this->scale_y[index], this->scale_z[index]));
+	}
+
+	//Each lane type wraps one register width, the kernels are written once against these
+	struct ScalarLane
+	{
+		typedef double Value;
+		static constexpr size_t width = 1;
+
+		static inline Value load(const double* source) { return *source; };
+		static inline Value gather(const double* base, const uint32_t* indices) { return base[indices[0]]; };
+		static inline void store(double* destination, Value value) { *destination = value; };
+		static inline Value set(double value) { return value; };
+		static inline Value add(Value a, Value b) { return a + b; };
+		static inline Value sub(Value a, Value b) { return a - b; };
+		static inline Value mul(Value a, Value b) { return a * b; };
+		static inline Value div(Value a, Value b) { return a / b; };
+	};
+
+#if defined(GENESIS_TRANSFORM_BATCH_AVX2)
+	struct SimdLane
+	{
+		typedef __m256d Value;
+		static constexpr size_t width = 4;
+
+		static inline Value load(const double* source) { return _mm256_loadu_pd(source); };
+		static inline Value gather(const double* base, const uint32_t* indices) { return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, _mm_loadu_si128((const __m128i*)indices), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8); };
+		static inline void store(double* destination, Value value) { _mm256_storeu_pd(destination, value); };
+		static inline Value set(double value) { return _mm256_set1_pd(value); };
+		static inline Value add(Value a, Value b) { return _mm256_add_pd(a, b); };
+		static inline Value sub(Value a, Value b) { return _mm256_sub_pd(a, b); };
+		static inline Value mul(Value a, Value b) { return _mm256_mul_pd(a, b); };
+		static inline Value div(Value a, Value b) { return _mm256_div_pd(a, b); };
+	};
+#elif defined(GENESIS_TRANSFORM_BATCH_SSE2)
+	struct SimdLane
+	{
+		typedef __m128d Value;
+		static constexpr size_t width = 2;
+
+		static inline Value load(const double* source) { return _mm_loadu_pd(source); };
+		static inline Value gather(const double* base, const uint32_t* indices) { return _mm_set_pd(base[indices[1]], base[indices[0]]); };
+		static inline void store(double* destination, Value value) { _mm_storeu_pd(destination, value); };
+		static inline Value set(double value) { return _mm_set1_pd(value); };
+		static inline Value add(Value a, Value b) { return _mm_add_pd(a, b); };
+		static inline Value sub(Value a, Value b) { return _mm_sub_pd(a, b); };
+		static inline Value mul(Value a, Value b) { return _mm_mul_pd(a, b); };
+		static inline Value div(Value a, Value b) { return _mm_div_pd(a, b); };
+	};
+#else
+	typedef ScalarLane SimdLane;
+#endif
+
+	//Same math as TransformUtils::transformByInplace and glm's quaternion operators, so results match the scalar path
+	//Returns the first index that wasn't processed, anything past the last full lane is left for the caller
+	template<typename Lane, bool Indexed>
+	size_t composeKernel(const TransformBatchD& parents, const uint32_t* parent_indices, const TransformBatchD& locals, TransformBatchD& results, size_t begin, size_t end)
+	{
+		typedef typename Lane::Value Value;
+		const Value two = Lane::set(2.0);
+
+		size_t i = begin;
+		for (; (i + Lane::width) <= end; i += Lane::width)
+		{
+			auto parent = [&](const vector<double>& component) -> Value
+			{
+				if constexpr (Indexed)
+				{
+					return Lane::gather(component.data(), parent_indices + i);
+				}
+				else
+				{
+					return Lane::load(component.data() + i);
+				}
+			};
+
+			const Value parent_px = parent(parents.position_x);
+			const Value parent_py = parent(parents.position_y);
+			const Value parent_pz = parent(parents.position_z);
+			const Value parent_qx = parent(parents.orientation_x);
+			const Value parent_qy = parent(parents.orientation_y);
+			const Value parent_qz = parent(parents.orientation_z);
+			const Value parent_qw = parent(parents.orientation_w);
+			const Value parent_sx = parent(parents.scale_x);
+			const Value parent_sy = parent(parents.scale_y);
+			const Value parent_sz = parent(parents.scale_z);
+
+			const Value local_px = Lane::load(locals.position_x.data() + i);
+			const Value local_py = Lane::load(locals.position_y.data() + i);
+			const Value local_pz = Lane::load(locals.position_z.data() + i);
+			const Value local_qx = Lane::load(locals.orientation_x.data() + i);
+			const Value local_qy = Lane::load(locals.orientation_y.data() + i);
+			const Value local_qz = Lane::load(locals.orientation_z.data() + i);
+			const Value local_qw = Lane::load(locals.orientation_w.data() + i);
+			const Value local_sx = Lane::load(locals.scale_x.data() + i);
+			const Value local_sy = Lane::load(locals.scale_y.data() + i);
+			const Value local_sz = Lane::load(locals.scale_z.data() + i);
+
+			//Position: parent_position + (parent_orientation * (local_position * parent_scale))
+			const Value vx = Lane::mul(local_px, parent_sx);
+			const Value vy = Lane::mul(local_py, parent_sy);
+			const Value vz = Lane::mul(local_pz, parent_sz);
+
+			const Value uvx = Lane::sub(Lane::mul(parent_qy, vz), Lane::mul(parent_qz, vy));
+			const Value uvy = Lane::sub(Lane::mul(parent_qz, vx), Lane::mul(parent_qx, vz));
+			const Value uvz = Lane::sub(Lane::mul(parent_qx, vy), Lane::mul(parent_qy, vx));
+
+			const Value uuvx = Lane::sub(Lane::mul(parent_qy, uvz), Lane::mul(parent_qz, uvy));
+			const Value uuvy = Lane::sub(Lane::mul(parent_qz, uvx), Lane::mul(parent_qx, uvz));
+			const Value uuvz = Lane::sub(Lane::mul(parent_qx, uvy), Lane::mul(parent_qy, uvx));
+
+			const Value position_x = Lane::add(parent_px, Lane::add(vx, Lane::mul(Lane::add(Lane::mul(uvx, parent_qw), uuvx), two)));
+			const Value position_y = Lane::add(parent_py, Lane::add(vy, Lane::mul(Lane::add(Lane::mul(uvy, parent_qw), uuvy), two)));
+			const Value position_z = Lane::add(parent_pz, Lane::add(vz, Lane::mul(Lane::add(Lane::mul(uvz, parent_qw), uuvz), two)));
+
+			//Orientation: parent_orientation * local_orientation
+			const Value orientation_w = Lane::sub(Lane::sub(Lane::sub(Lane::mul(parent_qw, local_qw), Lane::mul(parent_qx, local_qx)), Lane::mul(parent_qy, local_qy)), Lane::mul(parent_qz, local_qz));
+			const Value orientation_x = Lane::sub(Lane::add(Lane::add(Lane::mul(parent_qw, local_qx), Lane::mul(parent_qx, local_qw)), Lane::mul(parent_qy, local_qz)), Lane::mul(parent_qz, local_qy));
+			const Value orientation_y = Lane::sub(Lane::add(Lane::add(Lane::mul(parent_qw, local_qy), Lane::mul(parent_qy, local_qw)), Lane::mul(parent_qz, local_qx)), Lane::mul(parent_qx, local_qz));
+			const Value orientation_z = Lane::sub(Lane::add(Lane::add(Lane::mul(parent_qw, local_qz), Lane::mul(parent_qz, local_qw)), Lane::mul(parent_qx, local_qy)), Lane::mul(parent_qy, local_qx));
+
+			Lane::store(results.position_x.data() + i, position_x);
+			Lane::store(results.position_y.data() + i, position_y);
+			Lane::store(results.position_z.data() + i, position_z);
+			Lane::store(results.orientation_x.data() + i, orientation_x);
+			Lane::store(results.orientation_y.data() + i, orientation_y);
+			Lane::store(results.orientation_z.data() + i, orientation_z);
+			Lane::store(results.orientation_w.data() + i, orientation_w);
+			Lane::store(results.scale_x.data() + i, Lane::mul(parent_sx, local_sx));
+			Lane::store(results.scale_y.data() + i, Lane::mul(parent_sy, local_sy));
+			Lane::store(results.scale_z.data() + i, Lane::mul(parent_sz, local_sz));
+		}
+
+		return i;
+	}
+
+	//Same math as glm::toMat3, the columns are worked out in lanes then written out one matrix at a time
+	template<typename Lane>
+	size_t matrixKernel(const TransformBatchD& transforms, size_t begin, size_t end, matrix4F* model_matrices, matrix3F* normal_matrices, const vector3D& position_offset)
+	{
+		typedef typename Lane::Value Value;
+		const Value one = Lane::set(1.0);
+		const Value two = Lane::set(2.0);
+		const Value offset_x = Lane::set(position_offset.x);
+		const Value offset_y = Lane::set(position_offset.y);
+		const Value offset_z = Lane::set(position_offset.z);
+
+		//[column][row][lane]
+		double rotation[3][3][Lane::width];
+		double scale[3][Lane::width];
+		double translation[3][Lane::width];
+
+		size_t i = begin;
+		for (; (i + Lane::width) <= end; i += Lane::width)
+		{
+			const Value qx = Lane::load(transforms.orientation_x.data() + i);
+			const Value qy = Lane::load(transforms.orientation_y.data() + i);
+			const Value qz = Lane::load(transforms.orientation_z.data() + i);
+			const Value qw = Lane::load(transforms.orientation_w.data() + i);
+
+			const Value qxx = Lane::mul(qx, qx);
+			const Value qyy = Lane::mul(qy, qy);
+			const Value qzz = Lane::mul(qz, qz);
+			const Value qxz = Lane::mul(qx, qz);
+			const Value qxy = Lane::mul(qx, qy);
+			const Value qyz = Lane::mul(qy, qz);
+			const Value qwx = Lane::mul(qw, qx);
+			const Value qwy = Lane::mul(qw, qy);
+			const Value qwz = Lane::mul(qw, qz);
+
+			Lane::store(rotation[0][0], Lane::sub(one, Lane::mul(two, Lane::add(qyy, qzz))));
+			Lane::store(rotation[0][1], Lane::mul(two, Lane::add(qxy, qwz)));
+			Lane::store(rotation[0][2], Lane::mul(two, Lane::sub(qxz, qwy)));
+
+			Lane::store(rotation[1][0], Lane::mul(two, Lane::sub(qxy, qwz)));
+			Lane::store(rotation[1][1], Lane::sub(one, Lane::mul(two, Lane::add(qxx, qzz))));
+			Lane::store(rotation[1][2], Lane::mul(two, Lane::add(qyz, qwx)));
+
+			Lane::store(rotation[2][0], Lane::mul(two, Lane::add(qxz, qwy)));
+			Lane::store(rotation[2][1], Lane::mul(two, Lane::sub(qyz, qwx)));
+			Lane::store(rotation[2][2], Lane::sub(one, Lane::mul(two, Lane::add(qxx, qyy))));
+
+			Lane::store(scale[0], Lane::load(transforms.scale_x.data() + i));
+			Lane::store(scale[1], Lane::load(transforms.scale_y.data() + i));
+			Lane::store(scale[2], Lane::load(transforms.scale_z.data() + i));
+
+			Lane::store(translation[0], Lane::sub(Lane::load(transforms.position_x.data() + i), offset_x));
+			Lane::store(translation[1], Lane::sub(Lane::load(transforms.position_y.data() + i), offset_y));
+			Lane::store(translation[2], Lane::sub(Lane::load(transforms.position_z.data() + i), offset_z));
+
+			for (size_t lane = 0; lane < Lane::width; lane++)
+			{
+				matrix4F& model = model_matrices[i - begin + lane];
+				for (size_t column = 0; column < 3; column++)
+				{
+					for (size_t row = 0; row < 3; row++)
+					{
+						model[column][row] = (float)(rotation[column][row][lane] * scale[column][lane]);
+					}
+					model[column][3] = 0.0f;
+					model[3][column] = (float)translation[column][lane];
+				}
+				model[3][3] = 1.0f;
+
+				if (normal_matrices != nullptr)
+				{
+					//transpose(inverse(rotation * scale)) is just rotation / scale
+					matrix3F& normal = normal_matrices[i - begin + lane];
+					for (size_t column = 0; column < 3; column++)
+					{
+						for (size_t row = 0; row < 3; row++)
+						{
+							normal[column][row] = (float)(rotation[column][row][lane] / scale[column][lane]);
+						}
+					}
+				}
+			}
+		}
+
+		return i;
+	}
+
+	void TransformBatch::compose(const TransformBatchD& parents, const TransformBatchD& locals, TransformBatchD& results, size_t begin, size_t end)
+	{
+		size_t remaining = composeKernel<SimdLane, false>(parents, nullptr, locals, results, begin, end);
+		composeKernel<ScalarLane, false>(parents, nullptr, locals, results, remaining, end);
+	}
+
+	void TransformBatch::composeIndexed(const TransformBatchD& parents, const uint32_t* parent_indices, const TransformBatchD& locals, TransformBatchD& results, size_t begin, size_t end)
+	{
+		size_t remaining = composeKernel<SimdLane, true>(parents, parent_indices, locals, results, begin, end);
+		composeKernel<ScalarLane, true>(parents, parent_indices, locals, results, remaining, end);
+	}
+
+	void TransformBatch::getModelMatrices(const TransformBatchD& transforms, size_t begin, size_t end, matrix4F* model_matrices, matrix3F* normal_matrices, const vector3D& position_offset)
+	{
+		size_t remaining = matrixKernel<SimdLane>(transforms, begin, end, model_matrices, normal_matrices, position_offset);
+		matrixKernel<ScalarLane>(transforms, remaining, end, model_matrices + (remaining - begin), (normal_matrices != nullptr) ? (normal_matrices + (remaining - begin)) : nullptr, position_offset);
+	}
+
+	const char* TransformBatch::getInstructionSet()
+	{
+#if defined(GENESIS_TRANSFORM_BATCH_AVX2)
+		return "AVX2";
+#elif defined(GENESIS_TRANSFORM_BATCH_SSE2)
+		return "SSE2";
+#else
+		return "Scalar";
+#endif
+	}
+}
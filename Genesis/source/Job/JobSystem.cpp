@@ -1,84 +1,491 @@
 #include "Genesis/Job/JobSystem.hpp"
 
-#define sleep_time_milliseconds 2
+//Number of failed attempts to find work before a thread goes to sleep
+#define spin_count 64
+
+#define invalid_job_index UINT32_MAX
+
+//Number of chunks per thread when parallel_for picks the chunk size, more chunks balance better but cost more overhead
+#define chunks_per_thread 4
 
 namespace Genesis
 {
+	//Identifies which JobSystem (if any) owns the current thread, so jobs spawned from jobs go to the local deque
+	static thread_local JobSystem* current_job_system = nullptr;
+	static thread_local uint32_t current_thread_id = 0;
+	static thread_local uint32_t steal_random_state = 2463534242u;
+
 	void workerthread(uint32_t thread_id, JobSystem* job_system)
 	{
 		GENESIS_ENGINE_INFO("Thread {} Start", thread_id);
 
+		current_job_system = job_system;
+		current_thread_id = thread_id;
+		steal_random_state = (thread_id + 1) * 2654435761u;
+
+		uint32_t failed_attempts = 0;
 		while (job_system->shouldThreadsRun())
 		{
-			JobStruct next_job;
-			bool got_job = job_system->job_queue.try_dequeue(next_job);
-			if (got_job)
+			JobStruct* next_job = nullptr;
+			if (job_system->tryGetJob(thread_id, next_job, true))
 			{
-				next_job.job(thread_id);
-
-				if (next_job.job_counter != nullptr)
-				{
-					(*next_job.job_counter)--;
-				}
+				job_system->executeJob(thread_id, next_job);
+				failed_attempts = 0;
 			}
-			else
+			else if (failed_attempts < spin_count)
 			{
+				failed_attempts++;
 				std::this_thread::yield();
 			}
+			else
+			{
+				job_system->parkThread();
+				failed_attempts = 0;
+			}
 		}
 
+		current_job_system = nullptr;
+
 		GENESIS_ENGINE_INFO("Thread {} Exit", thread_id);
 	}
 
-	JobSystem::JobSystem()
+	JobSystem::JobSystem(uint32_t thread_count, uint32_t max_jobs)
+		:global_queues{ ConcurrentQueue<JobStruct*>(max_jobs), ConcurrentQueue<JobStruct*>(max_jobs) }, background_queue(max_jobs), main_thread_queue(max_jobs)
 	{
-		uint32_t thread_count = std::thread::hardware_concurrency();
-		this->threads.resize(thread_count);
+		this->main_thread_id = std::this_thread::get_id();
+
+		this->job_pool_size = max_jobs;
+		this->job_pool = std::make_unique<JobStruct[]>(max_jobs);
+		for (uint32_t i = 0; i < max_jobs; i++)
+		{
+			this->job_pool[i].next_free.store((i + 1) < max_jobs ? (i + 1) : invalid_job_index, std::memory_order_relaxed);
+		}
+		this->free_job_head.store(0, std::memory_order_relaxed);
+
+		if (thread_count == 0)
+		{
+			uint32_t hardware_threads = std::thread::hardware_concurrency();
+			thread_count = (hardware_threads > 1) ? (hardware_threads - 1) : 1;
+		}
+
+		//With a single job thread it has to stay free for frame work, background jobs are then run by the main thread through runBackgroundJob
+		this->max_background_jobs = thread_count - 1;
+
+		this->workers.resize(thread_count);
+		for (uint32_t i = 0; i < thread_count; i++)
+		{
+			this->workers[i] = std::make_unique<Worker>();
+		}
+
+		//Threads are started after all the workers exist, since any thread may try to steal from any other
 		for (uint32_t i = 0; i < thread_count; i++)
 		{
-			this->threads[i] = std::thread(&workerthread, i, this);
+			this->workers[i]->thread = std::thread(&workerthread, i, this);
 		}
 	}
 
 	JobSystem::~JobSystem()
 	{
-		should_threads_run = false;
+		{
+			std::lock_guard<std::mutex> lock(this->park_mutex);
+			this->should_threads_run.store(false, std::memory_order_release);
+		}
+		this->park_condition.notify_all();
+		this->wait_condition.notify_all();
 
-		for (uint32_t i = 0; i < this->threads.size(); i++)
+		for (uint32_t i = 0; i < this->workers.size(); i++)
 		{
-			//this->job_queue.enqueue(nullptr);//Push empty jobs to trigger exiting
+			this->workers[i]->thread.join();
 		}
 
-		for (uint32_t i = 0; i < this->threads.size(); i++)
+		//Any jobs that never got to run are owned by the pool, so they go away with it
+	}
+
+	void JobSystem::addJob(JobType job, JobCounter* counter, JobPriority priority)
+	{
+		if (counter != nullptr)
 		{
-			this->threads[i].join();
+			(*counter)++;
 		}
+
+		JobStruct* job_struct = this->allocateJob();
+		job_struct->job = std::move(job);
+		job_struct->job_counter = counter;
+		job_struct->priority = priority;
+		this->pushJob(job_struct);
 	}
 
-	void Genesis::JobSystem::addJob(JobType job, JobCounter* counter)
+	void JobSystem::addJobs(JobType* jobs, size_t job_count, JobCounter* counter, JobPriority priority)
 	{
-		(*counter)++;
+		if (counter != nullptr)
+		{
+			(*counter) += (uint32_t)job_count;
+		}
 
-		bool has_enqueued = this->job_queue.try_enqueue({ job, counter });
+		for (size_t i = 0; i < job_count; i++)
+		{
+			JobStruct* job_struct = this->allocateJob();
+			job_struct->job = jobs[i];
+			job_struct->job_counter = counter;
+			job_struct->priority = priority;
+			this->pushJob(job_struct);
+		}
+	}
+
+	void JobSystem::addMainThreadJob(JobType job, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			(*counter)++;
+		}
+
+		JobStruct* job_struct = this->allocateJob();
+		job_struct->job = std::move(job);
+		job_struct->job_counter = counter;
+		job_struct->priority = JobPriority::Critical;
+
+		bool has_enqueued = this->main_thread_queue.enqueue(job_struct);
 		GENESIS_ENGINE_ASSERT(has_enqueued == true, "Failed to enqueue job");
+
+		//Must be seq_cst, pairs with the waiting_threads increment in waitForCounter
+		this->queued_main_thread_jobs.fetch_add(1, std::memory_order_seq_cst);
+		this->notifyWaitingThreads();
 	}
 
-	void JobSystem::addJobs(JobType* jobs, size_t job_count, JobCounter* counter)
+	uint32_t JobSystem::runMainThreadJobs()
 	{
-		(*counter)++;
+		GENESIS_ENGINE_ASSERT(this->isMainThread(), "Main thread jobs can only be run on the main thread");
 
-		for (size_t i = 0; i < job_count; i++)
+		//Only what was queued up to now, so a job that queues another main thread job can't keep this going forever
+		int64_t job_count = this->queued_main_thread_jobs.load(std::memory_order_acquire);
+		uint32_t jobs_run = 0;
+
+		JobStruct* job = nullptr;
+		while (jobs_run < job_count && this->main_thread_queue.try_dequeue(job))
 		{
-			bool has_enqueued = this->job_queue.try_enqueue({ jobs[i], counter });
-			GENESIS_ENGINE_ASSERT(has_enqueued == true, "Failed to enqueue job");
+			this->queued_main_thread_jobs.fetch_sub(1, std::memory_order_relaxed);
+			this->executeJob(this->getCurrentThreadId(), job);
+			jobs_run++;
+		}
+
+		return jobs_run;
+	}
+
+	uint32_t JobSystem::getCurrentThreadId()
+	{
+		if (current_job_system == this)
+		{
+			return current_thread_id;
 		}
+
+		return this->getNumberOfJobThreads();
 	}
 
 	void JobSystem::waitForCounter(JobCounter& counter)
 	{
-		while (counter != 0)
+		const uint32_t thread_id = this->getCurrentThreadId();
+		const bool is_main_thread = this->isMainThread();
+
+		uint32_t failed_attempts = 0;
+		while (counter.load(std::memory_order_acquire) != 0)
+		{
+			//The main thread may be waiting on a job only it can run
+			if (is_main_thread && this->runMainThreadJobs() != 0)
+			{
+				failed_attempts = 0;
+				continue;
+			}
+
+			//Help out rather than spin, this is what keeps nested fan-out/fan-in from starving the pool
+			JobStruct* next_job = nullptr;
+			if (this->tryGetJob(thread_id, next_job))
+			{
+				this->executeJob(thread_id, next_job);
+				failed_attempts = 0;
+			}
+			else if (failed_attempts < spin_count)
+			{
+				failed_attempts++;
+				std::this_thread::yield();
+			}
+			else
+			{
+				//The remaining jobs are running on other threads, sleep until one finishes or new work shows up
+				std::unique_lock<std::mutex> lock(this->park_mutex);
+
+				//Must be seq_cst, pairs with the counter decrement in executeJob
+				this->waiting_threads.fetch_add(1, std::memory_order_seq_cst);
+				this->wait_condition.wait(lock, [&]()
+				{
+					return (counter.load(std::memory_order_seq_cst) == 0) || (this->queued_jobs.load(std::memory_order_seq_cst) > 0)
+						|| (is_main_thread && this->queued_main_thread_jobs.load(std::memory_order_seq_cst) > 0) || !this->shouldThreadsRun();
+				});
+				this->waiting_threads.fetch_sub(1, std::memory_order_seq_cst);
+				failed_attempts = 0;
+			}
+		}
+	}
+
+	bool JobSystem::runPendingJob()
+	{
+		const uint32_t thread_id = this->getCurrentThreadId();
+
+		JobStruct* next_job = nullptr;
+		if (this->tryGetJob(thread_id, next_job))
+		{
+			this->executeJob(thread_id, next_job);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JobSystem::runBackgroundJob()
+	{
+		if (this->max_background_jobs != 0 || this->queued_background_jobs.load(std::memory_order_relaxed) <= 0)
+		{
+			return false;
+		}
+
+		//Claimed the same way a job thread would, executeJob gives the slot back
+		this->running_background_jobs.fetch_add(1, std::memory_order_acq_rel);
+
+		JobStruct* job = nullptr;
+		if (this->background_queue.try_dequeue(job))
+		{
+			this->queued_background_jobs.fetch_sub(1, std::memory_order_relaxed);
+			this->executeJob(this->getCurrentThreadId(), job);
+			return true;
+		}
+
+		this->running_background_jobs.fetch_sub(1, std::memory_order_acq_rel);
+		return false;
+	}
+
+	JobStruct* JobSystem::allocateJob()
+	{
+		uint64_t head = this->free_job_head.load(std::memory_order_acquire);
+		while (true)
+		{
+			uint32_t index = (uint32_t)head;
+			if (index == invalid_job_index)
+			{
+				//Pool is exhausted, run something to free up a slot rather than allocate
+				//The main thread also has to run its own jobs here, nothing else will free those slots
+				if (!this->runPendingJob() && (!this->isMainThread() || (this->runMainThreadJobs() == 0 && !this->runBackgroundJob())))
+				{
+					std::this_thread::yield();
+				}
+				head = this->free_job_head.load(std::memory_order_acquire);
+				continue;
+			}
+
+			uint32_t next = this->job_pool[index].next_free.load(std::memory_order_relaxed);
+			uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+			if (this->free_job_head.compare_exchange_weak(head, new_head, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return &this->job_pool[index];
+			}
+		}
+	}
+
+	void JobSystem::freeJob(JobStruct* job)
+	{
+		const uint32_t index = (uint32_t)(job - this->job_pool.get());
+
+		uint64_t head = this->free_job_head.load(std::memory_order_relaxed);
+		uint64_t new_head;
+		do
+		{
+			job->next_free.store((uint32_t)head, std::memory_order_relaxed);
+			new_head = (((head >> 32) + 1) << 32) | index;
+		} while (!this->free_job_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	size_t JobSystem::getChunkSize(size_t count, size_t grain_size)
+	{
+		//Job threads plus the calling thread
+		const size_t thread_count = (size_t)this->getNumberOfJobThreads() + 1;
+		const size_t target_chunks = thread_count * chunks_per_thread;
+		const size_t auto_size = (count + target_chunks - 1) / target_chunks;
+		return std::max(std::max(auto_size, grain_size), (size_t)1);
+	}
+
+	void JobSystem::pushJob(JobStruct* job)
+	{
+		if (job->priority == JobPriority::Background)
+		{
+			//Background jobs are never pushed to a worker's deque, so stealing frame work can't pick one up
+			bool has_enqueued = this->background_queue.enqueue(job);
+			GENESIS_ENGINE_ASSERT(has_enqueued == true, "Failed to enqueue job");
+
+			//Must be seq_cst, pairs with the parked_threads check in parkThread
+			this->queued_background_jobs.fetch_add(1, std::memory_order_seq_cst);
+			this->notifyParkedThreads();
+			return;
+		}
+
+		const size_t priority_index = (size_t)job->priority;
+		bool has_enqueued = false;
+
+		if (current_job_system == this)
+		{
+			has_enqueued = this->workers[current_thread_id]->queues[priority_index].push(job);
+		}
+
+		if (!has_enqueued)
+		{
+			has_enqueued = this->global_queues[priority_index].enqueue(job);
+			GENESIS_ENGINE_ASSERT(has_enqueued == true, "Failed to enqueue job");
+		}
+
+		//Must be seq_cst, pairs with the parked_threads check in parkThread
+		this->queued_jobs.fetch_add(1, std::memory_order_seq_cst);
+
+		this->notifyParkedThreads();
+		this->notifyWaitingThreads();
+	}
+
+	void JobSystem::notifyParkedThreads()
+	{
+		if (this->parked_threads.load(std::memory_order_seq_cst) != 0)
+		{
+			std::lock_guard<std::mutex> lock(this->park_mutex);
+			this->park_condition.notify_one();
+		}
+	}
+
+	void JobSystem::notifyWaitingThreads()
+	{
+		if (this->waiting_threads.load(std::memory_order_seq_cst) != 0)
+		{
+			std::lock_guard<std::mutex> lock(this->park_mutex);
+			this->wait_condition.notify_all();
+		}
+	}
+
+	bool JobSystem::tryGetJob(uint32_t thread_id, JobStruct*& job, bool allow_background)
+	{
+		job = nullptr;
+
+		//All critical work anywhere in the pool goes before any normal work
+		if (this->tryGetFrameJob(thread_id, JobPriority::Critical, job) || this->tryGetFrameJob(thread_id, JobPriority::Normal, job))
+		{
+			return true;
+		}
+
+		return allow_background && this->tryGetBackgroundJob(job);
+	}
+
+	bool JobSystem::tryGetFrameJob(uint32_t thread_id, JobPriority priority, JobStruct*& job)
+	{
+		const size_t priority_index = (size_t)priority;
+
+		//Own deque first, newest job is the most likely to be hot in cache
+		//Threads outside the pool don't own a deque
+		if (thread_id < this->workers.size())
+		{
+			job = this->workers[thread_id]->queues[priority_index].pop();
+		}
+
+		if (job == nullptr)
+		{
+			this->global_queues[priority_index].try_dequeue(job);
+		}
+
+		if (job == nullptr)
+		{
+			//Steal the oldest job from a random victim
+			const uint32_t worker_count = (uint32_t)this->workers.size();
+
+			steal_random_state ^= steal_random_state << 13;
+			steal_random_state ^= steal_random_state >> 17;
+			steal_random_state ^= steal_random_state << 5;
+			const uint32_t start = steal_random_state % worker_count;
+
+			for (uint32_t i = 0; i < worker_count && job == nullptr; i++)
+			{
+				uint32_t victim = (start + i) % worker_count;
+				if (victim != thread_id)
+				{
+					job = this->workers[victim]->queues[priority_index].steal();
+				}
+			}
+		}
+
+		if (job != nullptr)
 		{
+			this->queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		return false;
+	}
 
+	bool JobSystem::tryGetBackgroundJob(JobStruct*& job)
+	{
+		if (this->queued_background_jobs.load(std::memory_order_relaxed) <= 0)
+		{
+			return false;
 		}
+
+		//Claim a background slot first, so a long load can never tie up every job thread
+		if (this->running_background_jobs.fetch_add(1, std::memory_order_acq_rel) >= this->max_background_jobs)
+		{
+			this->running_background_jobs.fetch_sub(1, std::memory_order_acq_rel);
+			return false;
+		}
+
+		if (this->background_queue.try_dequeue(job))
+		{
+			this->queued_background_jobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		this->running_background_jobs.fetch_sub(1, std::memory_order_acq_rel);
+		return false;
+	}
+
+	void JobSystem::executeJob(uint32_t thread_id, JobStruct* job)
+	{
+		job->job(thread_id);
+
+		JobCounter* counter = job->job_counter;
+		const bool is_background = (job->priority == JobPriority::Background);
+		job->job = nullptr;
+		job->job_counter = nullptr;
+		job->priority = JobPriority::Normal;
+		this->freeJob(job);
+
+		if (is_background)
+		{
+			//Must be seq_cst, a parked thread may have skipped queued background work while every slot was taken
+			this->running_background_jobs.fetch_sub(1, std::memory_order_seq_cst);
+			if (this->queued_background_jobs.load(std::memory_order_seq_cst) > 0)
+			{
+				this->notifyParkedThreads();
+			}
+		}
+
+		//Must be seq_cst, pairs with the waiting_threads check in waitForCounter
+		if (counter != nullptr && counter->fetch_sub(1, std::memory_order_seq_cst) == 1)
+		{
+			this->notifyWaitingThreads();
+		}
+	}
+
+	void JobSystem::parkThread()
+	{
+		std::unique_lock<std::mutex> lock(this->park_mutex);
+
+		//Must be seq_cst, pairs with the queued job increments in pushJob so a wakeup can't be missed
+		this->parked_threads.fetch_add(1, std::memory_order_seq_cst);
+		this->park_condition.wait(lock, [this]()
+		{
+			const bool has_background_job = (this->queued_background_jobs.load(std::memory_order_seq_cst) > 0)
+				&& (this->running_background_jobs.load(std::memory_order_seq_cst) < this->max_background_jobs);
+			return (this->queued_jobs.load(std::memory_order_seq_cst) > 0) || has_background_job || !this->shouldThreadsRun();
+		});
+		this->parked_threads.fetch_sub(1, std::memory_order_seq_cst);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,215 @@
+#include "Genesis/Job/TaskGraph.hpp"
+
+#include <sstream>
+#include <iomanip>
+
+namespace Genesis
+{
+	TaskNodeId TaskGraph::addNode(const string& name, function<void()> task, bool main_thread)
+	{
+		std::unique_ptr<Node> node = std::make_unique<Node>();
+		node->name = name;
+		node->task = task;
+		node->main_thread = main_thread;
+		this->has_main_thread_nodes |= main_thread;
+
+		this->nodes.push_back(std::move(node));
+		this->order_dirty = true;
+		return (TaskNodeId)(this->nodes.size() - 1);
+	}
+
+	void TaskGraph::addEdge(TaskNodeId before, TaskNodeId after)
+	{
+		GENESIS_ENGINE_ASSERT(before < this->nodes.size(), "Invalid task node");
+		GENESIS_ENGINE_ASSERT(after < this->nodes.size(), "Invalid task node");
+		GENESIS_ENGINE_ASSERT(before != after, "Task node can't depend on itself");
+
+		this->nodes[before]->successors.push_back(after);
+		this->nodes[after]->predecessors.push_back(before);
+		this->order_dirty = true;
+	}
+
+	void TaskGraph::buildOrder()
+	{
+		//Kahn's algorithm, also catches cycles
+		vector<uint32_t> in_degree(this->nodes.size());
+		for (size_t i = 0; i < this->nodes.size(); i++)
+		{
+			in_degree[i] = (uint32_t)this->nodes[i]->predecessors.size();
+		}
+
+		this->sorted_nodes.clear();
+		for (TaskNodeId i = 0; i < this->nodes.size(); i++)
+		{
+			if (in_degree[i] == 0)
+			{
+				this->sorted_nodes.push_back(i);
+			}
+		}
+
+		for (size_t i = 0; i < this->sorted_nodes.size(); i++)
+		{
+			for (TaskNodeId successor : this->nodes[this->sorted_nodes[i]]->successors)
+			{
+				in_degree[successor]--;
+				if (in_degree[successor] == 0)
+				{
+					this->sorted_nodes.push_back(successor);
+				}
+			}
+		}
+
+		GENESIS_ENGINE_ASSERT(this->sorted_nodes.size() == this->nodes.size(), "Task graph has a cycle");
+		this->order_dirty = false;
+	}
+
+	void TaskGraph::execute(JobSystem* job_system)
+	{
+		GENESIS_PROFILE_FUNCTION("TaskGraph::execute");
+
+		if (this->order_dirty)
+		{
+			this->buildOrder();
+		}
+
+		this->execute_start = std::chrono::high_resolution_clock::now();
+
+		if (job_system == nullptr)
+		{
+			this->job_system = nullptr;
+			for (TaskNodeId node_id : this->sorted_nodes)
+			{
+				this->runNode(node_id);
+			}
+			return;
+		}
+
+		GENESIS_ENGINE_ASSERT(job_system->isMainThread() || !this->has_main_thread_nodes, "Task graphs with main thread nodes have to be executed from the main thread");
+
+		this->job_system = job_system;
+		this->graph_counter.store(0, std::memory_order_relaxed);
+		for (auto& node : this->nodes)
+		{
+			node->pending_dependencies.store((uint32_t)node->predecessors.size(), std::memory_order_relaxed);
+		}
+
+		for (TaskNodeId node_id = 0; node_id < this->nodes.size(); node_id++)
+		{
+			if (this->nodes[node_id]->predecessors.empty())
+			{
+				this->scheduleNode(node_id);
+			}
+		}
+
+		//Every node job is tracked by the counter, a node schedules its successors before its own job finishes so it only hits zero once the whole graph is done
+		//On the main thread this also runs the main thread nodes as they become ready, from a job it helps with the rest and parks when there is nothing left to run
+		this->job_system->waitForCounter(this->graph_counter);
+	}
+
+	void TaskGraph::scheduleNode(TaskNodeId node_id)
+	{
+		auto job = [this, node_id](uint32_t thread_id)
+		{
+			this->runNode(node_id);
+		};
+
+		//Frame stages are what the frame is waiting on, so they go ahead of anything they spawn
+		if (this->nodes[node_id]->main_thread)
+		{
+			this->job_system->addMainThreadJob(job, &this->graph_counter);
+		}
+		else
+		{
+			this->job_system->addJob(job, &this->graph_counter, JobPriority::Critical);
+		}
+	}
+
+	void TaskGraph::runNode(TaskNodeId node_id)
+	{
+		using clock = std::chrono::high_resolution_clock;
+		Node& node = *this->nodes[node_id];
+
+		node.thread_id = (this->job_system != nullptr) ? this->job_system->getCurrentThreadId() : 0;
+		node.start_time = std::chrono::duration<double, std::milli>(clock::now() - this->execute_start).count();
+		node.task();
+		node.end_time = std::chrono::duration<double, std::milli>(clock::now() - this->execute_start).count();
+
+		if (this->job_system != nullptr)
+		{
+			for (TaskNodeId successor : node.successors)
+			{
+				if (this->nodes[successor]->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					this->scheduleNode(successor);
+				}
+			}
+		}
+	}
+
+	string TaskGraph::dump()
+	{
+		if (this->order_dirty)
+		{
+			this->buildOrder();
+		}
+
+		//Longest path by node duration, walking in dependency order
+		vector<double> path_time(this->nodes.size(), 0.0);
+		vector<int64_t> path_previous(this->nodes.size(), -1);
+		int64_t critical_end = -1;
+
+		for (TaskNodeId node_id : this->sorted_nodes)
+		{
+			Node& node = *this->nodes[node_id];
+			for (TaskNodeId predecessor : node.predecessors)
+			{
+				if (path_time[predecessor] > path_time[node_id])
+				{
+					path_time[node_id] = path_time[predecessor];
+					path_previous[node_id] = predecessor;
+				}
+			}
+			path_time[node_id] += node.end_time - node.start_time;
+
+			if (critical_end == -1 || path_time[node_id] > path_time[critical_end])
+			{
+				critical_end = node_id;
+			}
+		}
+
+		vector<bool> on_critical_path(this->nodes.size(), false);
+		for (int64_t node_id = critical_end; node_id != -1; node_id = path_previous[node_id])
+		{
+			on_critical_path[node_id] = true;
+		}
+
+		std::stringstream stream;
+		stream << std::fixed << std::setprecision(3);
+		stream << "Task Graph: " << this->nodes.size() << " nodes";
+		if (critical_end != -1)
+		{
+			stream << ", critical path " << path_time[critical_end] << "ms";
+		}
+		stream << "\n";
+
+		for (TaskNodeId node_id : this->sorted_nodes)
+		{
+			Node& node = *this->nodes[node_id];
+			stream << (on_critical_path[node_id] ? " * " : "   ");
+			stream << node.name << " [" << (node.main_thread ? "main" : "job") << " thread " << node.thread_id << "]";
+			stream << " start " << node.start_time << "ms, took " << (node.end_time - node.start_time) << "ms";
+
+			if (!node.successors.empty())
+			{
+				stream << " ->";
+				for (TaskNodeId successor : node.successors)
+				{
+					stream << " " << this->nodes[successor]->name;
+				}
+			}
+			stream << "\n";
+		}
+
+		return stream.str();
+	}
+}
@@ -1,6 +1,8 @@
 #include "Genesis/LegacyRendering/LegacySceneRenderer.hpp"
 
 #include "Genesis/Platform/FileSystem.hpp"
+#include "Genesis/Rendering/Frustum.hpp"
+#include "Genesis/Rendering/DrawSort.hpp"
 
 namespace Genesis
 {
@@ -13,6 +15,16 @@ namespace Genesis
 			backend->setUniformMat4f("environment.view_projection_matrix", view_projection_matrix);
 		}
 
+		static void write_clusters(LegacyBackend* backend, const LightClusters& clusters)
+		{
+			backend->setUniformMat4f("clusters.view_matrix", clusters.view_matrix);
+			backend->setUniform3u("clusters.size", vector3U(LightClusters::size_x, LightClusters::size_y, LightClusters::size_z));
+			backend->setUniform2f("clusters.tan_half_fov", clusters.tan_half_fov);
+			backend->setUniform1f("clusters.z_near", clusters.z_near);
+			backend->setUniform1f("clusters.log_depth_ratio", log(clusters.z_far / clusters.z_near));
+			backend->setUniform1u("clusters.directional_light_count", clusters.directional_light_count);
+		}
+
 		static void write_material_uniform(LegacyBackend* backend, const Material& material)
 		{
 			backend->setUniform4f("material.albedo", material.albedo_factor);
@@ -49,33 +61,12 @@ namespace Genesis
 				backend->setUniformTexture("material.emissive_texture", 4, material.emissive_texture.texture->texture);
 			}
 		}
-
-		static void write_transform_uniform(LegacyBackend* backend, TransformD& transform)
-		{
-			backend->setUniformMat4f("matrices.model", transform.getModelMatrix());
-			backend->setUniformMat3f("matrices.normal", transform.getNormalMatrix());
-		}
-
-		static void write_directional_light(LegacyBackend* backend, const DirectionalLight& light, const vector3F& light_direction)
-		{
-			backend->setUniform3f("directional_light.base.color", light.color);
-			backend->setUniform1f("directional_light.base.intensity", light.intensity);
-			backend->setUniform3f("directional_light.direction", light_direction);
-		}
-
-		static void write_point_light(LegacyBackend* backend, const PointLight& light, const vector3F& light_position)
-		{
-			backend->setUniform3f("point_light.base.color", light.color);
-			backend->setUniform1f("point_light.base.intensity", light.intensity);
-			backend->setUniform1f("point_light.range", light.range);
-			backend->setUniform2f("point_light.attenuation", light.attenuation);
-			backend->setUniform3f("point_light.position", light_position);
-		}
 	};
 
-	LegacySceneRenderer::LegacySceneRenderer(LegacyBackend* backend)
+	LegacySceneRenderer::LegacySceneRenderer(LegacyBackend* backend, JobSystem* job_system)
 	{
 		this->backend = backend;
+		this->job_system = job_system;
 
 		string vert_data = "";
 		string frag_data = "";
@@ -85,12 +76,8 @@ namespace Genesis
 		this->ambient_program = this->backend->createShaderProgram(vert_data.data(), (uint32_t)vert_data.size(), frag_data.data(), (uint32_t)frag_data.size());
 
 		frag_data.clear();
-		FileSystem::loadShaderString("res/shaders_opengl/ModelDirectional.frag", frag_data);
-		this->directional_program = this->backend->createShaderProgram(vert_data.data(), (uint32_t)vert_data.size(), frag_data.data(), (uint32_t)frag_data.size());
-
-		frag_data.clear();
-		FileSystem::loadShaderString("res/shaders_opengl/ModelPoint.frag", frag_data);
-		this->point_program = this->backend->createShaderProgram(vert_data.data(), (uint32_t)vert_data.size(), frag_data.data(), (uint32_t)frag_data.size());
+		FileSystem::loadShaderString("res/shaders_opengl/ModelForward.frag", frag_data);
+		this->forward_program = this->backend->createShaderProgram(vert_data.data(), (uint32_t)vert_data.size(), frag_data.data(), (uint32_t)frag_data.size());
 
 		string comp_data = "";
 		FileSystem::loadShaderString("res/shaders_opengl/GammaCorrection.glsl", comp_data);
@@ -100,8 +87,7 @@ namespace Genesis
 	LegacySceneRenderer::~LegacySceneRenderer()
 	{
 		this->backend->destoryShaderProgram(this->ambient_program);
-		this->backend->destoryShaderProgram(this->directional_program);
-		this->backend->destoryShaderProgram(this->point_program);
+		this->backend->destoryShaderProgram(this->forward_program);
 		this->backend->destoryShaderProgram(this->gamma_correction_program);
 	}
 
@@ -110,81 +96,131 @@ namespace Genesis
 		this->backend->bindFramebuffer(target_framebuffer);
 		this->backend->clearFramebuffer(true, true);
 
-		matrix4F view_projection_matrix = active_camera.camera.get_projection_matrix(target_size) * active_camera.transform.getViewMatirx();
+		const matrix4F view_matrix = active_camera.transform.getViewMatirx();
+		matrix4F view_projection_matrix = active_camera.camera.get_projection_matrix(target_size) * view_matrix;
 
-		const PipelineSettings ambient_settings = { CullMode::Back, DepthTest::Test_And_Write, DepthOp::Less, BlendOp::None, BlendFactor::One, BlendFactor::Zero };
-		this->backend->setPipelineState(ambient_settings);
-
-		//Draw ambient pass
+		//Lights are binned on a job while the models are culled and sorted
+		JobCounter cluster_counter{ 0 };
+		if (settings.lighting)
 		{
-			this->backend->bindShaderProgram(this->ambient_program);
-
-			LegacyShaderUniform::write_environment(this->backend, lighting.ambient_light, (vector3F)active_camera.transform.getPosition(), view_projection_matrix);
+			const float aspect_ratio = (float)target_size.x / (float)target_size.y;
+			auto build_clusters = [this, &render_list, &view_matrix, &active_camera, aspect_ratio](uint32_t thread_id)
+			{
+				this->light_clusters.build(render_list, view_matrix, active_camera.camera, aspect_ratio);
+			};
 
-			for (ModelStruct& mesh : render_list.models)
+			if (this->job_system != nullptr)
+			{
+				this->job_system->addJob(build_clusters, &cluster_counter);
+			}
+			else
 			{
-				LegacyShaderUniform::write_transform_uniform(this->backend, mesh.transform);
-				LegacyShaderUniform::write_material_uniform(this->backend, *mesh.material);
+				build_clusters(0);
+			}
+		}
 
-				this->backend->bindVertexBuffer(mesh.mesh->vertex_buffer);
-				this->backend->bindIndexBuffer(mesh.mesh->index_buffer);
+		this->cull_models(render_list, settings, view_projection_matrix);
 
-				this->backend->drawIndex(mesh.mesh->index_count, 0);
-			}
+		const vector3F camera_position = (vector3F)active_camera.transform.getPosition();
+		this->build_draw_commands(render_list, settings, camera_position, active_camera.camera.z_far);
+		radixSortDrawCommands(this->draw_commands, this->sort_scratch);
+
+		const PipelineSettings opaque_settings = { CullMode::Back, DepthTest::Test_And_Write, DepthOp::Less, BlendOp::None, BlendFactor::One, BlendFactor::Zero };
+
+		//One instance per command, each batch of commands below reads its own range
+		this->model_instances.resize(this->draw_commands.size());
+		for (size_t i = 0; i < this->draw_commands.size(); i++)
+		{
+			const ModelStruct& model = render_list.models[this->draw_commands[i].model_index];
+			this->model_instances[i] = { model.model_matrix, model.normal_matrix };
 		}
 
-		const PipelineSettings light_settings = { CullMode::Back, DepthTest::Test_Only, DepthOp::Equal, BlendOp::Add, BlendFactor::One, BlendFactor::One };
-		this->backend->setPipelineState(light_settings);
+		VertexElementType instance_elements[] =
+		{
+			VertexElementType::float_4, VertexElementType::float_4, VertexElementType::float_4, VertexElementType::float_4,
+			VertexElementType::float_3, VertexElementType::float_3, VertexElementType::float_3,
+		};
+		VertexInputDescriptionCreateInfo instance_description;
+		instance_description.input_elements = instance_elements;
+		instance_description.input_elements_count = (uint32_t)(sizeof(instance_elements) / sizeof(VertexElementType));
+		static_assert(sizeof(ModelInstance) == (sizeof(float) * 25), "ModelInstance has to be tightly packed to match instance_elements");
+
+		if (!this->model_instances.empty())
+		{
+			this->backend->uploadInstanceBuffer(this->model_instances.data(), this->model_instances.size() * sizeof(ModelInstance), instance_description);
+		}
 
 		if (settings.lighting)
 		{
-			//Draw directional light pass
+			if (this->job_system != nullptr)
 			{
-				this->backend->bindShaderProgram(this->directional_program);
-				LegacyShaderUniform::write_environment(this->backend, lighting.ambient_light, (vector3F)active_camera.transform.getPosition(), view_projection_matrix);
+				this->job_system->waitForCounter(cluster_counter);
+			}
+
+			this->backend->uploadStorageBuffer(ClusterBinding::Lights, this->light_clusters.lights.data(), this->light_clusters.lights.size() * sizeof(ClusterLight));
+			this->backend->uploadStorageBuffer(ClusterBinding::Ranges, this->light_clusters.cluster_ranges.data(), this->light_clusters.cluster_ranges.size() * sizeof(uint32_t));
+			this->backend->uploadStorageBuffer(ClusterBinding::Indices, this->light_clusters.light_indices.data(), this->light_clusters.light_indices.size() * sizeof(uint32_t));
+		}
+
+		//Commands are grouped by pass, then material, then mesh, so each run sharing all three is one instanced draw and most binds can be skipped
+		//Uniforms belong to the program, switching pass forgets everything that was bound
+		uint32_t current_pass = DrawPass::Count;
+		const Material* bound_material = nullptr;
+		const Mesh* bound_mesh = nullptr;
 
-				for (ModelStruct& mesh : render_list.models)
+		const size_t command_count = this->draw_commands.size();
+		for (size_t batch_begin = 0; batch_begin < command_count;)
+		{
+			const uint32_t pass = DrawKey::getPass(this->draw_commands[batch_begin].key);
+			const ModelStruct& model = render_list.models[this->draw_commands[batch_begin].model_index];
+
+			//Compared by pointer, ids past the key's field width can share bits
+			size_t batch_end = batch_begin + 1;
+			while (batch_end < command_count)
+			{
+				const DrawCommand& next_command = this->draw_commands[batch_end];
+				const ModelStruct& next_model = render_list.models[next_command.model_index];
+				if (DrawKey::getPass(next_command.key) != pass || next_model.material != model.material || next_model.mesh != model.mesh)
 				{
-					LegacyShaderUniform::write_transform_uniform(this->backend, mesh.transform);
-					LegacyShaderUniform::write_material_uniform(this->backend, *mesh.material);
-
-					this->backend->bindVertexBuffer(mesh.mesh->vertex_buffer);
-					this->backend->bindIndexBuffer(mesh.mesh->index_buffer);
-
-					for (DirectionalLightStruct& light : render_list.directional_lights)
-					{
-						if (light.light.enabled)
-						{
-							LegacyShaderUniform::write_directional_light(this->backend, light.light, (vector3F)light.transform.getForward());
-							this->backend->drawIndex(mesh.mesh->index_count, 0);
-						}
-					}
+					break;
 				}
+				batch_end++;
 			}
 
-			//Draw point light pass
+			const uint32_t first_instance = (uint32_t)batch_begin;
+			const uint32_t instance_count = (uint32_t)(batch_end - batch_begin);
+			batch_begin = batch_end;
+
+			if (pass != current_pass)
 			{
-				this->backend->bindShaderProgram(this->point_program);
-				LegacyShaderUniform::write_environment(this->backend, lighting.ambient_light, (vector3F)active_camera.transform.getPosition(), view_projection_matrix);
+				current_pass = pass;
+				bound_material = nullptr;
+				bound_mesh = nullptr;
+
+				this->backend->setPipelineState(opaque_settings);
+				this->backend->bindShaderProgram(this->get_pass_program(pass));
+				LegacyShaderUniform::write_environment(this->backend, lighting.ambient_light, camera_position, view_projection_matrix);
 
-				for (ModelStruct& mesh : render_list.models)
+				if (pass == DrawPass::Forward)
 				{
-					LegacyShaderUniform::write_transform_uniform(this->backend, mesh.transform);
-					LegacyShaderUniform::write_material_uniform(this->backend, *mesh.material);
-
-					this->backend->bindVertexBuffer(mesh.mesh->vertex_buffer);
-					this->backend->bindIndexBuffer(mesh.mesh->index_buffer);
-
-					for (PointLightStruct& light : render_list.point_lights)
-					{
-						if (light.light.enabled)
-						{
-							LegacyShaderUniform::write_point_light(this->backend, light.light, (vector3F)light.transform.getPosition());
-							this->backend->drawIndex(mesh.mesh->index_count, 0);
-						}
-					}
+					LegacyShaderUniform::write_clusters(this->backend, this->light_clusters);
 				}
 			}
+
+			if (model.material != bound_material)
+			{
+				LegacyShaderUniform::write_material_uniform(this->backend, *model.material);
+				bound_material = model.material;
+			}
+
+			if (model.mesh != bound_mesh)
+			{
+				this->backend->bindVertexBuffer(model.mesh->vertex_buffer);
+				this->backend->bindIndexBuffer(model.mesh->index_buffer);
+				bound_mesh = model.mesh;
+			}
+
+			this->backend->drawIndexInstanced(model.mesh->index_count, instance_count, first_instance);
 		}
 
 		this->backend->bindFramebuffer(nullptr);
@@ -196,4 +232,90 @@ namespace Genesis
 		this->backend->dispatchCompute(target_size.x, target_size.y, 1);
 		this->backend->bindShaderProgram(nullptr);
 	}
-}
\ No newline at end of file
+
+	void LegacySceneRenderer::cull_models(const SceneRenderList& render_list, const RenderSettings& settings, const matrix4F& view_projection_matrix)
+	{
+		GENESIS_PROFILE_FUNCTION("LegacySceneRenderer::cull_models");
+
+		const size_t model_count = render_list.models.size();
+		this->visible_models.clear();
+		this->visible_models.reserve(model_count);
+
+		if (!settings.frustrum_culling || render_list.model_bounds.size() != model_count)
+		{
+			for (size_t i = 0; i < model_count; i++)
+			{
+				this->visible_models.push_back((uint32_t)i);
+			}
+		}
+		else
+		{
+			Frustum frustum(view_projection_matrix);
+			this->visibility_results.resize(model_count);
+			frustum.testBoxes(render_list.model_bounds, 0, model_count, this->visibility_results.data());
+
+			for (size_t i = 0; i < model_count; i++)
+			{
+				if (this->visibility_results[i] != 0)
+				{
+					this->visible_models.push_back((uint32_t)i);
+				}
+			}
+		}
+
+		this->backend->addModelStats(this->visible_models.size(), model_count - this->visible_models.size());
+	}
+
+	void LegacySceneRenderer::build_draw_commands(const SceneRenderList& render_list, const RenderSettings& settings, const vector3F& camera_position, float far_distance)
+	{
+		GENESIS_PROFILE_FUNCTION("LegacySceneRenderer::build_draw_commands");
+
+		//Ids only have to be stable for the frame, they're handed out in the order resources are first seen
+		this->material_ids.clear();
+		this->mesh_ids.clear();
+
+		const Material* last_material = nullptr;
+		const Mesh* last_mesh = nullptr;
+		uint32_t material_id = 0;
+		uint32_t mesh_id = 0;
+
+		this->model_keys.resize(this->visible_models.size());
+		for (size_t i = 0; i < this->visible_models.size(); i++)
+		{
+			const ModelStruct& model = render_list.models[this->visible_models[i]];
+
+			if (model.material != last_material)
+			{
+				material_id = this->material_ids.try_emplace(model.material, (uint32_t)this->material_ids.size()).first->second;
+				last_material = model.material;
+			}
+
+			if (model.mesh != last_mesh)
+			{
+				mesh_id = this->mesh_ids.try_emplace(model.mesh, (uint32_t)this->mesh_ids.size()).first->second;
+				last_mesh = model.mesh;
+			}
+
+			//Front to back so the ambient pass writes the nearest depth first
+			const vector3F center(render_list.model_bounds.center_x[this->visible_models[i]], render_list.model_bounds.center_y[this->visible_models[i]], render_list.model_bounds.center_z[this->visible_models[i]]);
+			const uint32_t depth = (far_distance > 0.0f) ? DrawKey::quantizeDepth(glm::length(center - camera_position) / far_distance) : 0;
+
+			this->model_keys[i] = DrawKey::pack(0, 0, material_id, mesh_id, depth);
+		}
+
+		//Every light is applied in the one forward pass, the ambient pass is only used with lighting turned off
+		const uint32_t pass = settings.lighting ? DrawPass::Forward : DrawPass::Ambient;
+		const uint64_t pass_bits = DrawKey::pack(pass, pass, 0, 0, 0);
+
+		this->draw_commands.resize(this->visible_models.size());
+		for (size_t i = 0; i < this->visible_models.size(); i++)
+		{
+			this->draw_commands[i] = { pass_bits | this->model_keys[i], this->visible_models[i] };
+		}
+	}
+
+	ShaderProgram LegacySceneRenderer::get_pass_program(uint32_t pass)
+	{
+		return (pass == DrawPass::Forward) ? this->forward_program : this->ambient_program;
+	}
+}
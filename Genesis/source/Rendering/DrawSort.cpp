@@ -0,0 +1,67 @@
+#include "Genesis/Rendering/DrawSort.hpp"
+
+#define radix_bits 8
+#define radix_buckets (1 << radix_bits)
+
+namespace Genesis
+{
+	void radixSortDrawCommands(vector<DrawCommand>& commands, vector<DrawCommand>& scratch)
+	{
+		GENESIS_PROFILE_FUNCTION("radixSortDrawCommands");
+
+		const size_t count = commands.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		scratch.resize(count);
+
+		//All the histograms in one read of the keys
+		constexpr uint32_t digit_count = 64 / radix_bits;
+		size_t histograms[digit_count][radix_buckets] = {};
+		for (const DrawCommand& command : commands)
+		{
+			for (uint32_t digit = 0; digit < digit_count; digit++)
+			{
+				histograms[digit][(command.key >> (digit * radix_bits)) & (radix_buckets - 1)]++;
+			}
+		}
+
+		DrawCommand* source = commands.data();
+		DrawCommand* destination = scratch.data();
+		for (uint32_t digit = 0; digit < digit_count; digit++)
+		{
+			size_t* histogram = histograms[digit];
+
+			//Every key has the same byte here, the pass wouldn't move anything
+			const uint32_t first_byte = (uint32_t)((source[0].key >> (digit * radix_bits)) & (radix_buckets - 1));
+			if (histogram[first_byte] == count)
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (uint32_t bucket = 0; bucket < radix_buckets; bucket++)
+			{
+				const size_t bucket_count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucket_count;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const uint32_t byte = (uint32_t)((source[i].key >> (digit * radix_bits)) & (radix_buckets - 1));
+				destination[histogram[byte]++] = source[i];
+			}
+
+			std::swap(source, destination);
+		}
+
+		//An odd number of passes leaves the result in scratch
+		if (source != commands.data())
+		{
+			commands.swap(scratch);
+		}
+	}
+}
@@ -1,5 +1,13 @@
 #include "Genesis/Rendering/Frustum.hpp"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GENESIS_FRUSTUM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GENESIS_FRUSTUM_SSE
+#endif
+
 namespace Genesis
 {
 	Frustum::Frustum(const matrix4F& matrix)
@@ -53,4 +61,128 @@ namespace Genesis
 
 		return true;
 	}
-}
\ No newline at end of file
+
+	bool Frustum::aabbTest(const vector3F& min, const vector3F& max) const
+	{
+		for (uint8_t i = 0; i < Plane::Count; i++)
+		{
+			//Only the corner furthest along the plane normal matters
+			vector3F positive_vertex = vector3F(
+				(planes[i].x >= 0.0f) ? max.x : min.x,
+				(planes[i].y >= 0.0f) ? max.y : min.y,
+				(planes[i].z >= 0.0f) ? max.z : min.z);
+
+			if ((planes[i].x * positive_vertex.x) + (planes[i].y * positive_vertex.y) + (planes[i].z * positive_vertex.z) + planes[i].w < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Frustum::testBoxes(const BoundingBoxBatch& boxes, size_t begin, size_t end, uint8_t* visible) const
+	{
+		//Center/extent form of the positive vertex test, the box is outside a plane if center distance + projected extent < 0
+		size_t index = begin;
+
+#if defined(GENESIS_FRUSTUM_AVX)
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+		for (; index + 8 <= end; index += 8)
+		{
+			const __m256 center_x = _mm256_loadu_ps(&boxes.center_x[index]);
+			const __m256 center_y = _mm256_loadu_ps(&boxes.center_y[index]);
+			const __m256 center_z = _mm256_loadu_ps(&boxes.center_z[index]);
+			const __m256 extent_x = _mm256_loadu_ps(&boxes.extent_x[index]);
+			const __m256 extent_y = _mm256_loadu_ps(&boxes.extent_y[index]);
+			const __m256 extent_z = _mm256_loadu_ps(&boxes.extent_z[index]);
+
+			__m256 outside = _mm256_setzero_ps();
+			for (uint8_t i = 0; i < Plane::Count; i++)
+			{
+				const __m256 normal_x = _mm256_set1_ps(planes[i].x);
+				const __m256 normal_y = _mm256_set1_ps(planes[i].y);
+				const __m256 normal_z = _mm256_set1_ps(planes[i].z);
+
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(normal_x, center_x), _mm256_mul_ps(normal_y, center_y));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(normal_z, center_z));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(planes[i].w));
+
+				__m256 radius = _mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(sign_mask, normal_x), extent_x), _mm256_mul_ps(_mm256_andnot_ps(sign_mask, normal_y), extent_y));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(sign_mask, normal_z), extent_z));
+
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+
+			const int outside_mask = _mm256_movemask_ps(outside);
+			for (size_t lane = 0; lane < 8; lane++)
+			{
+				visible[index - begin + lane] = ((outside_mask >> lane) & 1) ? 0 : 1;
+			}
+		}
+#elif defined(GENESIS_FRUSTUM_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		for (; index + 4 <= end; index += 4)
+		{
+			const __m128 center_x = _mm_loadu_ps(&boxes.center_x[index]);
+			const __m128 center_y = _mm_loadu_ps(&boxes.center_y[index]);
+			const __m128 center_z = _mm_loadu_ps(&boxes.center_z[index]);
+			const __m128 extent_x = _mm_loadu_ps(&boxes.extent_x[index]);
+			const __m128 extent_y = _mm_loadu_ps(&boxes.extent_y[index]);
+			const __m128 extent_z = _mm_loadu_ps(&boxes.extent_z[index]);
+
+			__m128 outside = _mm_setzero_ps();
+			for (uint8_t i = 0; i < Plane::Count; i++)
+			{
+				const __m128 normal_x = _mm_set1_ps(planes[i].x);
+				const __m128 normal_y = _mm_set1_ps(planes[i].y);
+				const __m128 normal_z = _mm_set1_ps(planes[i].z);
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(normal_x, center_x), _mm_mul_ps(normal_y, center_y));
+				distance = _mm_add_ps(distance, _mm_mul_ps(normal_z, center_z));
+				distance = _mm_add_ps(distance, _mm_set1_ps(planes[i].w));
+
+				__m128 radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, normal_x), extent_x), _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_y), extent_y));
+				radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_z), extent_z));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			const int outside_mask = _mm_movemask_ps(outside);
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				visible[index - begin + lane] = ((outside_mask >> lane) & 1) ? 0 : 1;
+			}
+		}
+#endif
+
+		for (; index < end; index++)
+		{
+			bool inside = true;
+			for (uint8_t i = 0; i < Plane::Count; i++)
+			{
+				const float distance = (planes[i].x * boxes.center_x[index]) + (planes[i].y * boxes.center_y[index]) + (planes[i].z * boxes.center_z[index]) + planes[i].w;
+				const float radius = (std::abs(planes[i].x) * boxes.extent_x[index]) + (std::abs(planes[i].y) * boxes.extent_y[index]) + (std::abs(planes[i].z) * boxes.extent_z[index]);
+				if ((distance + radius) < 0.0f)
+				{
+					inside = false;
+					break;
+				}
+			}
+			visible[index - begin] = inside ? 1 : 0;
+		}
+	}
+
+	const char* Frustum::getInstructionSet()
+	{
+#if defined(GENESIS_FRUSTUM_AVX)
+		return "AVX";
+#elif defined(GENESIS_FRUSTUM_SSE)
+		return "SSE";
+#else
+		return "Scalar";
+#endif
+	}
+}
@@ -0,0 +1,150 @@
+#include "Genesis/Rendering/LightClusters.hpp"
+
+//Cutoff cosine for point lights, lower than any real cosine so the cone test always passes
+#define point_light_cutoff -2.0f
+
+namespace Genesis
+{
+	void LightClusters::build(const SceneRenderList& render_list, const matrix4F& view_matrix, const Camera& camera, float aspect_ratio)
+	{
+		GENESIS_PROFILE_FUNCTION("LightClusters::build");
+
+		//Same field of view as Camera::get_projection_matrix, which keeps the horizontal angle fixed
+		this->view_matrix = view_matrix;
+		this->tan_half_fov.x = tan(glm::radians(camera.frame_of_view) / 2.0f);
+		this->tan_half_fov.y = this->tan_half_fov.x / aspect_ratio;
+		this->z_near = camera.z_near;
+		this->z_far = camera.z_far;
+
+		if (this->tan_half_fov != this->bounds_tan_half_fov || this->z_near != this->bounds_z_near || this->z_far != this->bounds_z_far)
+		{
+			this->buildClusterBounds();
+		}
+
+		this->lights.clear();
+		this->view_positions.clear();
+
+		for (const DirectionalLightStruct& light : render_list.directional_lights)
+		{
+			if (light.light.enabled)
+			{
+				this->lights.push_back({ vector4F(0.0f), vector4F(light.light.color, light.light.intensity), vector4F((vector3F)light.transform.getForward(), 0.0f), vector4F(0.0f) });
+			}
+		}
+		this->directional_light_count = (uint32_t)this->lights.size();
+
+		//Lights without a range can't reach anything
+		for (const PointLightStruct& light : render_list.point_lights)
+		{
+			if (light.light.enabled && light.light.range > 0.0f)
+			{
+				this->lights.push_back({ vector4F((vector3F)light.transform.getPosition(), light.light.range), vector4F(light.light.color, light.light.intensity), vector4F(0.0f, 0.0f, 0.0f, point_light_cutoff), vector4F(light.light.attenuation, 0.0f, 0.0f) });
+			}
+		}
+
+		for (const SpotLightStruct& light : render_list.spot_lights)
+		{
+			if (light.light.enabled && light.light.range > 0.0f)
+			{
+				this->lights.push_back({ vector4F((vector3F)light.transform.getPosition(), light.light.range), vector4F(light.light.color, light.light.intensity), vector4F((vector3F)light.transform.getForward(), cos(glm::radians(light.light.cutoff))), vector4F(light.light.attenuation, 0.0f, 0.0f) });
+			}
+		}
+
+		for (uint32_t z = 0; z < size_z; z++)
+		{
+			this->slice_lights[z].clear();
+		}
+
+		//Spot lights are binned by the sphere around their whole range, the cone only trims them in the shader
+		const float log_depth_ratio = log(this->z_far / this->z_near);
+		this->view_positions.resize(this->lights.size());
+		for (uint32_t i = this->directional_light_count; i < (uint32_t)this->lights.size(); i++)
+		{
+			const ClusterLight& light = this->lights[i];
+			const vector3F view_position = vector3F(view_matrix * vector4F(vector3F(light.position_range), 1.0f));
+			this->view_positions[i] = view_position;
+
+			const float range = light.position_range.w;
+			const float min_depth = -view_position.z - range;
+			const float max_depth = -view_position.z + range;
+			if (max_depth < this->z_near || min_depth > this->z_far)
+			{
+				continue;
+			}
+
+			const float min_slice = log(std::max(min_depth, this->z_near) / this->z_near) / log_depth_ratio * (float)size_z;
+			const float max_slice = log(std::min(max_depth, this->z_far) / this->z_near) / log_depth_ratio * (float)size_z;
+			const uint32_t first_slice = std::min((uint32_t)std::max(min_slice, 0.0f), size_z - 1);
+			const uint32_t last_slice = std::min((uint32_t)std::max(max_slice, 0.0f), size_z - 1);
+			for (uint32_t z = first_slice; z <= last_slice; z++)
+			{
+				this->slice_lights[z].push_back(i);
+			}
+		}
+
+		//Every cluster's lights are appended in light order, so the lists come out the same each frame
+		this->cluster_ranges.resize(cluster_count * 2);
+		this->light_indices.clear();
+		for (uint32_t z = 0; z < size_z; z++)
+		{
+			for (uint32_t y = 0; y < size_y; y++)
+			{
+				for (uint32_t x = 0; x < size_x; x++)
+				{
+					const uint32_t cluster_index = x + (y * size_x) + (z * size_x * size_y);
+					const AxisAlignedBoundingBox& bounds = this->cluster_bounds[cluster_index];
+
+					const uint32_t offset = (uint32_t)this->light_indices.size();
+					for (uint32_t light_index : this->slice_lights[z])
+					{
+						if (bounds.overlapsSphere(this->view_positions[light_index], this->lights[light_index].position_range.w))
+						{
+							this->light_indices.push_back(light_index);
+						}
+					}
+
+					this->cluster_ranges[(cluster_index * 2) + 0] = offset;
+					this->cluster_ranges[(cluster_index * 2) + 1] = (uint32_t)this->light_indices.size() - offset;
+				}
+			}
+		}
+	}
+
+	void LightClusters::buildClusterBounds()
+	{
+		this->bounds_tan_half_fov = this->tan_half_fov;
+		this->bounds_z_near = this->z_near;
+		this->bounds_z_far = this->z_far;
+
+		//View space looks down -z, a tile's edges are lines through the eye so its box is set by the corners at the slice's near and far depths
+		const float depth_ratio = this->z_far / this->z_near;
+		this->cluster_bounds.resize(cluster_count);
+		for (uint32_t z = 0; z < size_z; z++)
+		{
+			const float slice_near = this->z_near * pow(depth_ratio, (float)z / (float)size_z);
+			const float slice_far = this->z_near * pow(depth_ratio, (float)(z + 1) / (float)size_z);
+
+			for (uint32_t y = 0; y < size_y; y++)
+			{
+				const float min_y = ((((float)y / (float)size_y) * 2.0f) - 1.0f) * this->tan_half_fov.y;
+				const float max_y = ((((float)(y + 1) / (float)size_y) * 2.0f) - 1.0f) * this->tan_half_fov.y;
+
+				for (uint32_t x = 0; x < size_x; x++)
+				{
+					const float min_x = ((((float)x / (float)size_x) * 2.0f) - 1.0f) * this->tan_half_fov.x;
+					const float max_x = ((((float)(x + 1) / (float)size_x) * 2.0f) - 1.0f) * this->tan_half_fov.x;
+
+					const vector2F near_min = vector2F(min_x, min_y) * slice_near;
+					const vector2F near_max = vector2F(max_x, max_y) * slice_near;
+					const vector2F far_min = vector2F(min_x, min_y) * slice_far;
+					const vector2F far_max = vector2F(max_x, max_y) * slice_far;
+
+					const vector2F box_min = glm::min(glm::min(near_min, near_max), glm::min(far_min, far_max));
+					const vector2F box_max = glm::max(glm::max(near_min, near_max), glm::max(far_min, far_max));
+
+					this->cluster_bounds[x + (y * size_x) + (z * size_x * size_y)] = AxisAlignedBoundingBox(vector3F(box_min, -slice_far), vector3F(box_max, -slice_near));
+				}
+			}
+		}
+	}
+}
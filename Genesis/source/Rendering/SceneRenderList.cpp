@@ -0,0 +1,267 @@
+#include "Genesis/Rendering/SceneRenderList.hpp"
+
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Scene/Hierarchy.hpp"
+#include "Genesis/Component/TransformComponent.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
+#include "Genesis/Job/JobSystem.hpp"
+
+//Matrices are built into stack buffers this many models at a time
+#define model_matrix_chunk_size 64
+
+//Hierarchy cache nodes handled by each extraction job, the chunks are merged in order afterwards
+#define node_chunk_size 1024
+
+//Minimum models per job when building matrices
+#define model_matrix_grain_size 1024
+
+namespace Genesis
+{
+	void addToRenderList(SceneRenderListChunk& render_list, EntityRegistry& registry, EntityHandle entity, const TransformD& world_transform)
+	{
+		if (const ModelComponent* model = registry.try_get<ModelComponent>(entity))
+		{
+			render_list.resources.addMesh(model->mesh);
+			render_list.resources.addMaterial(model->material);
+			render_list.models.push_back({ model->mesh.get(), model->material.get(), world_transform, matrix4F(1.0f), matrix3F(1.0f) });
+		}
+
+		if (const DirectionalLight* light = registry.try_get<DirectionalLight>(entity))
+		{
+			render_list.directional_lights.push_back({ *light, world_transform });
+		}
+
+		if (const PointLight* light = registry.try_get<PointLight>(entity))
+		{
+			render_list.point_lights.push_back({ *light, world_transform });
+		}
+
+		if (const SpotLight* light = registry.try_get<SpotLight>(entity))
+		{
+			render_list.spot_lights.push_back({ *light, world_transform });
+		}
+	}
+
+	//World transforms were already resolved by TransformResolveSystem, so a range of cache nodes is just a lookup each
+	void addCachedRangeToRenderList(SceneRenderListChunk& render_list, EntityRegistry& registry, const TransformHierarchyCache& cache, bool has_interpolated, size_t range_begin, size_t range_end)
+	{
+		for (size_t i = range_begin; i < range_end; i++)
+		{
+			//Destroyed since the cache was built
+			if (cache.entities[i] == null_entity)
+			{
+				continue;
+			}
+
+			//Simulated bodies are drawn at this frame's blend rather than the last fixed step
+			//Root transforms leave out the root's position and orientation, so the whole tree can be placed at the blend instead
+			const InterpolatedTransform* interpolated_transform = has_interpolated ? registry.try_get<InterpolatedTransform>(cache.entities[cache.root_index[i]]) : nullptr;
+			if (interpolated_transform != nullptr)
+			{
+				const TransformD root_pose(interpolated_transform->render.getPosition(), interpolated_transform->render.getOrientation());
+				addToRenderList(render_list, registry, cache.entities[i], TransformUtils::transformBy(root_pose, cache.root_transforms.get(i)));
+			}
+			else
+			{
+				addToRenderList(render_list, registry, cache.entities[i], cache.world_transforms.get(i));
+			}
+		}
+	}
+
+	//Trees under a root without a Transform aren't in the hierarchy cache, there are usually only a handful so they are walked here
+	//Uses an explicit stack, so a long chain can't overflow
+	void addUncachedToRenderList(SceneRenderListChunk& render_list, EntityRegistry& registry, const vector<EntityHandle>& roots)
+	{
+		vector<std::pair<EntityHandle, TransformD>> stack;
+		for (EntityHandle root : roots)
+		{
+			stack.emplace_back(root, TransformD());
+			while (!stack.empty())
+			{
+				const EntityHandle entity = stack.back().first;
+				TransformD world_transform = stack.back().second;
+				stack.pop_back();
+
+				if (const TransformD* transform = registry.try_get<TransformD>(entity))
+				{
+					world_transform = TransformUtils::transformBy(world_transform, *transform);
+				}
+
+				addToRenderList(render_list, registry, entity, world_transform);
+
+				for (EntityHandle child : EntityHiearchy(&registry, entity))
+				{
+					stack.emplace_back(child, world_transform);
+				}
+			}
+		}
+	}
+
+	void buildModelMatrixRange(SceneRenderList& render_list, size_t range_begin, size_t range_end)
+	{
+		TransformBatchD& transforms = render_list.model_transforms;
+		for (size_t i = range_begin; i < range_end; i++)
+		{
+			transforms.set(i, render_list.models[i].transform);
+		}
+
+		matrix4F model_matrices[model_matrix_chunk_size];
+		matrix3F normal_matrices[model_matrix_chunk_size];
+		for (size_t begin = range_begin; begin < range_end; begin += model_matrix_chunk_size)
+		{
+			const size_t end = std::min(begin + model_matrix_chunk_size, range_end);
+			TransformBatch::getModelMatrices(transforms, begin, end, model_matrices, normal_matrices);
+
+			for (size_t i = begin; i < end; i++)
+			{
+				ModelStruct& model = render_list.models[i];
+				model.model_matrix = model_matrices[i - begin];
+				model.normal_matrix = normal_matrices[i - begin];
+
+				//The box around the transformed mesh box, each axis of the extent picks up the absolute scaled rotation
+				const BoundingBox& mesh_bounds = model.mesh->bounding_box;
+				const vector3F center = (mesh_bounds.min + mesh_bounds.max) * 0.5f;
+				const vector3F extent = (mesh_bounds.max - mesh_bounds.min) * 0.5f;
+				matrix3F absolute_matrix = matrix3F(model.model_matrix);
+				absolute_matrix[0] = glm::abs(absolute_matrix[0]);
+				absolute_matrix[1] = glm::abs(absolute_matrix[1]);
+				absolute_matrix[2] = glm::abs(absolute_matrix[2]);
+				render_list.model_bounds.set(i, vector3F(model.model_matrix * vector4F(center, 1.0f)), absolute_matrix * extent);
+			}
+		}
+	}
+
+	void buildModelMatrices(SceneRenderList& render_list, JobSystem* job_system)
+	{
+		GENESIS_PROFILE_FUNCTION("buildModelMatrices");
+
+		const size_t count = render_list.models.size();
+		render_list.model_transforms.resize(count);
+		render_list.model_bounds.resize(count);
+
+		if (job_system != nullptr)
+		{
+			job_system->parallel_for_chunks(0, count, model_matrix_grain_size, [&render_list](uint32_t thread_id, size_t begin, size_t end)
+			{
+				buildModelMatrixRange(render_list, begin, end);
+			});
+		}
+		else
+		{
+			buildModelMatrixRange(render_list, 0, count);
+		}
+	}
+
+	//Concatenates the chunks in order, so the list doesn't depend on which job finished first
+	void mergeRenderListChunks(SceneRenderList& render_list, size_t chunk_count)
+	{
+		GENESIS_PROFILE_FUNCTION("mergeRenderListChunks");
+
+		size_t model_count = 0;
+		size_t directional_light_count = 0;
+		size_t point_light_count = 0;
+		size_t spot_light_count = 0;
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			model_count += render_list.chunks[i].models.size();
+			directional_light_count += render_list.chunks[i].directional_lights.size();
+			point_light_count += render_list.chunks[i].point_lights.size();
+			spot_light_count += render_list.chunks[i].spot_lights.size();
+		}
+
+		render_list.models.reserve(model_count);
+		render_list.directional_lights.reserve(directional_light_count);
+		render_list.point_lights.reserve(point_light_count);
+		render_list.spot_lights.reserve(spot_light_count);
+
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			const SceneRenderListChunk& chunk = render_list.chunks[i];
+			render_list.models.insert(render_list.models.end(), chunk.models.begin(), chunk.models.end());
+			render_list.directional_lights.insert(render_list.directional_lights.end(), chunk.directional_lights.begin(), chunk.directional_lights.end());
+			render_list.point_lights.insert(render_list.point_lights.end(), chunk.point_lights.begin(), chunk.point_lights.end());
+			render_list.spot_lights.insert(render_list.spot_lights.end(), chunk.spot_lights.begin(), chunk.spot_lights.end());
+			render_list.resources.merge(chunk.resources);
+		}
+	}
+
+	void buildSceneRenderList(Scene* scene, SceneRenderList& render_list, JobSystem* job_system)
+	{
+		GENESIS_PROFILE_FUNCTION("buildSceneRenderList");
+
+		render_list.clear();
+
+		EntityRegistry& registry = scene->registry;
+		const TransformHierarchyCache* cache = registry.try_ctx<TransformHierarchyCache>();
+		const bool cache_current = (cache != nullptr) && cache->valid && (cache->version == HierarchyUtils::getVersion(registry));
+		GENESIS_ENGINE_ASSERT(cache_current, "Render lists are built from the resolved hierarchy, run TransformResolveSystem first");
+		if (!cache_current)
+		{
+			return;
+		}
+
+		//Everything not in the cache is under a root without a Transform, the scene components entity is always one of them
+		render_list.roots.clear();
+		if (registry.alive() > (cache->entities.size() - cache->dead_count + 1))
+		{
+			registry.each([&](EntityHandle entity)
+			{
+				if (entity != scene->scene_components.handle() && !registry.has<ChildNode>(entity) && !registry.has<TransformD>(entity))
+				{
+					render_list.roots.push_back(entity);
+				}
+			});
+		}
+
+		//Most scenes have nothing simulated, so the per node lookup can be skipped entirely
+		const bool has_interpolated = (registry.size<InterpolatedTransform>() != 0);
+
+		//The cache nodes are split evenly, the uncached trees get one extra chunk at the end
+		const size_t node_count = cache->entities.size();
+		const size_t cached_chunk_count = (node_count + node_chunk_size - 1) / node_chunk_size;
+		const size_t chunk_count = cached_chunk_count + (render_list.roots.empty() ? 0 : 1);
+		if (render_list.chunks.size() < chunk_count)
+		{
+			render_list.chunks.resize(chunk_count);
+		}
+
+		//Chunks left over from a bigger scene would otherwise keep its resources alive
+		for (size_t i = chunk_count; i < render_list.chunks.size(); i++)
+		{
+			render_list.chunks[i].clear();
+		}
+
+		//Each chunk only writes to its own lists, the registry and cache are only read
+		auto extract_chunk = [&registry, cache, has_interpolated, cached_chunk_count, &render_list](size_t chunk_index)
+		{
+			SceneRenderListChunk& chunk = render_list.chunks[chunk_index];
+			chunk.clear();
+
+			if (chunk_index < cached_chunk_count)
+			{
+				const size_t begin = chunk_index * node_chunk_size;
+				const size_t end = std::min(begin + node_chunk_size, cache->entities.size());
+				addCachedRangeToRenderList(chunk, registry, *cache, has_interpolated, begin, end);
+			}
+			else
+			{
+				addUncachedToRenderList(chunk, registry, render_list.roots);
+			}
+		};
+
+		if (job_system != nullptr)
+		{
+			job_system->parallel_for(0, chunk_count, 1, extract_chunk);
+		}
+		else
+		{
+			for (size_t i = 0; i < chunk_count; i++)
+			{
+				extract_chunk(i);
+			}
+		}
+
+		mergeRenderListChunks(render_list, chunk_count);
+		buildModelMatrices(render_list, job_system);
+	}
+}
\ No newline at end of file
@@ -10,10 +10,34 @@ namespace Genesis
 		this->texture_pool = texture_pool;
 	}
 
+	//Every texture slot createMaterial reads
+	static const char* texture_keys[] = { "albedo_texture", "normal_texture", "metallic_roughness_texture", "occlusion_texture", "emissive_texture" };
+
+	void MaterialPool::getTextureNames(const YAML::Node& material_node, vector<string>& texture_names)
+	{
+		for (const char* texture_key : texture_keys)
+		{
+			if (material_node[texture_key])
+			{
+				texture_names.push_back(material_node[texture_key].as<string>());
+			}
+		}
+	}
+
+	shared_ptr<Material> MaterialPool::createResource(const string& key, const YAML::Node& material_node)
+	{
+		shared_ptr<Material> material = this->createMaterial(key, material_node);
+		this->addResource(key, material);
+		return material;
+	}
+
 	shared_ptr<Material> MaterialPool::loadResource(const string& key)
 	{
-		YAML::Node material_node = YAML::LoadFile(key);
+		return this->createMaterial(key, YAML::LoadFile(key));
+	}
 
+	shared_ptr<Material> MaterialPool::createMaterial(const string& key, const YAML::Node& material_node)
+	{
 		shared_ptr<Material> material = std::make_shared<Material>(key);
 
 		if (material_node["albedo_factor"])
@@ -1,7 +1,5 @@
 #include "Genesis/Resource/MeshPool.hpp"
 
-#include "Genesis/Resource/ObjLoader.hpp"
-
 namespace Genesis
 {
 	MeshPool::MeshPool(LegacyBackend* backend)
@@ -14,4 +12,11 @@ namespace Genesis
 		MeshStruct mesh = ObjLoader::loadMesh(this->backend, key);
 		return std::make_shared<Mesh>(key, this->backend, mesh);
 	}
+
+	shared_ptr<Mesh> MeshPool::createResource(const string& key, const MeshData& mesh_data)
+	{
+		shared_ptr<Mesh> mesh = std::make_shared<Mesh>(key, this->backend, ObjLoader::createMesh(this->backend, mesh_data));
+		this->addResource(key, mesh);
+		return mesh;
+	}
 }
\ No newline at end of file
@@ -8,6 +8,11 @@
 namespace Genesis
 {
 	MeshStruct ObjLoader::loadMesh(LegacyBackend* backend, const string& filename)
+	{
+		return ObjLoader::createMesh(backend, ObjLoader::readMesh(filename));
+	}
+
+	MeshData ObjLoader::readMesh(const string& filename)
 	{
 		tinyobj::attrib_t attrib;
 		vector<tinyobj::shape_t> shapes;
@@ -16,18 +21,18 @@ namespace Genesis
 
 		GENESIS_ENGINE_ASSERT((tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str())), "Can't load Mesh");
 
-		MeshStruct return_mesh = {};
-		vector<MeshVertex> vertices;
-		vector<uint32_t> indices;
+		MeshData mesh_data;
+		vector<MeshVertex>& vertices = mesh_data.vertices;
+		vector<uint32_t>& indices = mesh_data.indices;
+
+		//Bounds of the whole mesh, used for culling
+		vector3F min_position = vector3F(std::numeric_limits<float>::max());
+		vector3F max_position = vector3F(std::numeric_limits<float>::lowest());
 
 		for (const auto& shape : shapes)
 		{
 			size_t index_offset = 0;
 
-			//TODO
-			vector3F min_position = vector3F(10000.0f);
-			vector3F max_position = vector3F(-10000.0f);
-
 			for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++)
 			{
 				size_t fv = shape.mesh.num_face_vertices[f];
@@ -60,10 +65,16 @@ namespace Genesis
 			//MeshPrimitive primitive;
 			//primitive.first_index = index_offset;
 			//primitive.index_count = shape.mesh.indices.size();
-			//primitive.bounding_box = { min_position, max_position };
 			//return_mesh.primitives.push_back(primitive);
 		}
 
+		if (vertices.empty())
+		{
+			min_position = vector3F(0.0f);
+			max_position = vector3F(0.0f);
+		}
+		mesh_data.bounding_box = BoundingBox(min_position, max_position);
+
 		//Calculate Tangent and Bitangent
 		for (size_t i = 0; i < indices.size(); i += 3)
 		{
@@ -94,6 +105,14 @@ namespace Genesis
 			vertices[index_3].bitangent = glm::normalize(glm::cross(vertices[index_3].tangent, vertices[index_3].normal));
 		}
 
+		return mesh_data;
+	}
+
+	MeshStruct ObjLoader::createMesh(LegacyBackend* backend, const MeshData& mesh_data)
+	{
+		MeshStruct return_mesh = {};
+		return_mesh.bounding_box = mesh_data.bounding_box;
+
 		VertexInputDescriptionCreateInfo create_info = {};
 		vector<VertexElementType> elements =
 		{
@@ -106,9 +125,9 @@ namespace Genesis
 		create_info.input_elements = elements.data();
 		create_info.input_elements_count = (uint32_t)elements.size();
 
-		return_mesh.vertex_buffer = backend->createVertexBuffer(vertices.data(), vertices.size() * sizeof(MeshVertex), create_info);
-		return_mesh.index_buffer = backend->createIndexBuffer(indices.data(), indices.size() * sizeof(uint32_t), IndexType::uint32);
-		return_mesh.index_count = (uint32_t)indices.size();
+		return_mesh.vertex_buffer = backend->createVertexBuffer(mesh_data.vertices.data(), mesh_data.vertices.size() * sizeof(MeshVertex), create_info);
+		return_mesh.index_buffer = backend->createIndexBuffer(mesh_data.indices.data(), mesh_data.indices.size() * sizeof(uint32_t), IndexType::uint32);
+		return_mesh.index_count = (uint32_t)mesh_data.indices.size();
 
 		return return_mesh;
 	}
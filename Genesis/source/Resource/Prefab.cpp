@@ -0,0 +1,201 @@
+#include "Genesis/Resource/Prefab.hpp"
+
+#include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Scene/Hierarchy.hpp"
+#include "Genesis/Scene/SceneSerializer.hpp"
+#include "Genesis/Component/NameComponent.hpp"
+#include "Genesis/Component/ModelComponent.hpp"
+#include "Genesis/Component/PhysicsComponents.hpp"
+#include "Genesis/Rendering/Camera.hpp"
+#include "Genesis/Rendering/Lights.hpp"
+
+namespace Genesis
+{
+	static vector<std::pair<size_t, Prefab::InstantiateFunction>>& getInstantiateFunctions()
+	{
+		//Transform and the hierarchy are handled by Prefab itself, since they differ per instance
+		static vector<std::pair<size_t, Prefab::InstantiateFunction>> instantiate_functions =
+		{
+			{ TypeInfo<NameComponent>::getHash(), &Prefab::instantiateComponent<NameComponent> },
+			{ TypeInfo<ModelComponent>::getHash(), &Prefab::instantiateComponent<ModelComponent> },
+			{ TypeInfo<Camera>::getHash(), &Prefab::instantiateComponent<Camera> },
+			{ TypeInfo<DirectionalLight>::getHash(), &Prefab::instantiateComponent<DirectionalLight> },
+			{ TypeInfo<PointLight>::getHash(), &Prefab::instantiateComponent<PointLight> },
+			{ TypeInfo<SpotLight>::getHash(), &Prefab::instantiateComponent<SpotLight> },
+			{ TypeInfo<RigidBodyTemplate>::getHash(), &Prefab::instantiateComponent<RigidBodyTemplate> },
+			{ TypeInfo<CollisionShapeTemplate>::getHash(), &Prefab::instantiateComponent<CollisionShapeTemplate> },
+			{ TypeInfo<TriggerShapeTemplate>::getHash(), &Prefab::instantiateComponent<TriggerShapeTemplate> },
+		};
+
+		return instantiate_functions;
+	}
+
+	void Prefab::registerComponent(size_t type_hash, InstantiateFunction instantiate_function)
+	{
+		auto& instantiate_functions = getInstantiateFunctions();
+		for (auto& pair : instantiate_functions)
+		{
+			if (pair.first == type_hash)
+			{
+				pair.second = instantiate_function;
+				return;
+			}
+		}
+
+		instantiate_functions.push_back({ type_hash, instantiate_function });
+	}
+
+	Prefab::Prefab(const string& file_path, ResourceManager* resource_manager)
+		:Resource(file_path)
+	{
+		Entity root = SceneSerializer().deserializeEntity(file_path.c_str(), &this->template_scene, resource_manager);
+		EntityRegistry& registry = this->template_scene.registry;
+
+		PrefabNode root_node;
+		root_node.template_entity = root.handle();
+		this->nodes.push_back(root_node);
+
+		for (uint32_t i = 0; i < this->nodes.size(); i++)
+		{
+			uint32_t prev = PrefabNode::no_node;
+			for (EntityHandle child : EntityHiearchy(&registry, this->nodes[i].template_entity))
+			{
+				const uint32_t child_index = (uint32_t)this->nodes.size();
+
+				PrefabNode child_node;
+				child_node.template_entity = child;
+				child_node.parent = i;
+				child_node.prev = prev;
+				this->nodes.push_back(child_node);
+
+				if (prev == PrefabNode::no_node)
+				{
+					this->nodes[i].first_child = child_index;
+				}
+				else
+				{
+					this->nodes[prev].next = child_index;
+				}
+
+				this->nodes[i].last_child = child_index;
+				this->nodes[i].child_count++;
+				prev = child_index;
+			}
+		}
+	}
+
+	void Prefab::instantiate(Scene* scene, const Transform* transforms, size_t count, vector<EntityHandle>* roots)
+	{
+		GENESIS_PROFILE_FUNCTION("Prefab::instantiate");
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		EntityRegistry& registry = scene->registry;
+
+		this->instance_entities.resize(this->nodes.size() * count);
+		registry.create(this->instance_entities.begin(), this->instance_entities.end());
+
+		Prefab::instantiateTransforms(*this, registry, this->instance_entities, transforms, count);
+
+		Prefab::instantiateHierarchy(*this, registry, this->instance_entities, count);
+
+		for (auto& pair : getInstantiateFunctions())
+		{
+			pair.second(*this, registry, this->instance_entities, count);
+		}
+
+		if (roots != nullptr)
+		{
+			roots->insert(roots->end(), this->instance_entities.begin(), this->instance_entities.begin() + count);
+		}
+	}
+
+	void Prefab::instantiateTransforms(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, const Transform* transforms, size_t count)
+	{
+		EntityRegistry& template_registry = prefab.template_scene.registry;
+
+		//Every root gets a transform so instances can be placed, even if the prefab's root didn't have one
+		const Transform* root_transform = template_registry.try_get<Transform>(prefab.nodes[0].template_entity);
+		vector<Transform> root_transforms(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			root_transforms[i] = (root_transform != nullptr) ? TransformUtils::transformBy(transforms[i], *root_transform) : transforms[i];
+		}
+
+		size_t total_count = count;
+		for (size_t i = 1; i < prefab.nodes.size(); i++)
+		{
+			total_count += template_registry.has<Transform>(prefab.nodes[i].template_entity) ? count : 0;
+		}
+
+		registry.reserve<Transform>(registry.size<Transform>() + total_count);
+		registry.insert<Transform>(entities.data(), entities.data() + count, root_transforms.begin(), root_transforms.end());
+
+		for (size_t i = 1; i < prefab.nodes.size(); i++)
+		{
+			if (template_registry.has<Transform>(prefab.nodes[i].template_entity))
+			{
+				const EntityHandle* first = entities.data() + (i * count);
+				registry.insert<Transform>(first, first + count, template_registry.get<Transform>(prefab.nodes[i].template_entity));
+			}
+		}
+	}
+
+	void Prefab::instantiateHierarchy(Prefab& prefab, EntityRegistry& registry, const vector<EntityHandle>& entities, size_t count)
+	{
+		if (prefab.nodes.size() < 2)
+		{
+			return;
+		}
+
+		auto getEntity = [&](uint32_t node, size_t instance)
+		{
+			return (node != PrefabNode::no_node) ? entities[(node * count) + instance] : null_entity;
+		};
+
+		size_t parent_count = 0;
+		for (const PrefabNode& node : prefab.nodes)
+		{
+			parent_count += (node.child_count > 0) ? count : 0;
+		}
+
+		registry.reserve<ParentNode>(registry.size<ParentNode>() + parent_count);
+		registry.reserve<ChildNode>(registry.size<ChildNode>() + ((prefab.nodes.size() - 1) * count));
+
+		//Links are written straight into place rather than going through addChild for every entity
+		vector<ParentNode> parent_nodes(count);
+		vector<ChildNode> child_nodes(count);
+		for (uint32_t node_index = 0; node_index < prefab.nodes.size(); node_index++)
+		{
+			const PrefabNode& node = prefab.nodes[node_index];
+			const EntityHandle* first = entities.data() + (node_index * count);
+
+			if (node.child_count > 0)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					parent_nodes[i].first = getEntity(node.first_child, i);
+					parent_nodes[i].last = getEntity(node.last_child, i);
+					parent_nodes[i].child_count = node.child_count;
+				}
+				registry.insert<ParentNode>(first, first + count, parent_nodes.begin(), parent_nodes.end());
+			}
+
+			if (node.parent != PrefabNode::no_node)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					child_nodes[i].prev = getEntity(node.prev, i);
+					child_nodes[i].next = getEntity(node.next, i);
+					child_nodes[i].parent = getEntity(node.parent, i);
+				}
+				registry.insert<ChildNode>(first, first + count, child_nodes.begin(), child_nodes.end());
+			}
+		}
+
+		HierarchyUtils::markChanged(registry);
+	}
+}
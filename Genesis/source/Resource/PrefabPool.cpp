@@ -0,0 +1,14 @@
+#include "Genesis/Resource/PrefabPool.hpp"
+
+namespace Genesis
+{
+	PrefabPool::PrefabPool(ResourceManager* resource_manager)
+	{
+		this->resource_manager = resource_manager;
+	}
+
+	shared_ptr<Prefab> PrefabPool::loadResource(const string& key)
+	{
+		return std::make_shared<Prefab>(key, this->resource_manager);
+	}
+}
@@ -5,34 +5,41 @@
 
 namespace Genesis
 {
-	uint8_t* loadTexture(const string& texture_file_path, vector2I& size, int32_t& channels)
+	void TextureData::freePixels(uint8_t* pixels)
 	{
-		return stbi_load(texture_file_path.c_str(), (int*)(&size.x), (int*)(&size.y), (int*)(&channels), STBI_default);
+		stbi_image_free(pixels);
 	}
 
-	void unloadTexture(uint8_t* data)
+	TexturePool::TexturePool(LegacyBackend* backend)
 	{
-		stbi_image_free(data);
+		this->backend = backend;
 	}
 
-	TexturePool::TexturePool(LegacyBackend* backend)
+	TextureData TexturePool::readTexture(const string& key)
 	{
-		this->backend = backend;
+		TextureData texture_data;
+		texture_data.pixels.reset(stbi_load(key.c_str(), (int*)(&texture_data.size.x), (int*)(&texture_data.size.y), (int*)(&texture_data.channels), STBI_default));
+		return texture_data;
 	}
 
 	shared_ptr<Texture> TexturePool::loadResource(const string& key)
 	{
-		Texture2D texture = nullptr;
+		return this->uploadTexture(key, TexturePool::readTexture(key));
+	}
 
-		//Load image
-		vector2I size;
-		int32_t channels;
-		uint8_t* data = loadTexture(key, size, channels);
+	shared_ptr<Texture> TexturePool::createResource(const string& key, const TextureData& texture_data)
+	{
+		shared_ptr<Texture> texture = this->uploadTexture(key, texture_data);
+		this->addResource(key, texture);
+		return texture;
+	}
 
+	shared_ptr<Texture> TexturePool::uploadTexture(const string& key, const TextureData& texture_data)
+	{
 		TextureCreateInfo create_info = {};
-		create_info.size = (vector2U)size;
+		create_info.size = (vector2U)texture_data.size;
 
-		switch (channels)
+		switch (texture_data.channels)
 		{
 		case 1:
 			create_info.format = ImageFormat::R_8;
@@ -48,8 +55,7 @@ namespace Genesis
 			break;
 		}
 
-		texture = this->backend->createTexture(create_info, data);
-		unloadTexture(data);
+		Texture2D texture = this->backend->createTexture(create_info, texture_data.pixels.get());
 
 		return std::make_shared<Texture>(key, this->backend, texture, create_info.size, create_info.format);
 	}
@@ -0,0 +1,284 @@
+#include "Genesis/Scene/DynamicAabbTree.hpp"
+
+namespace Genesis
+{
+	DynamicAabbTree::DynamicAabbTree(float margin)
+	{
+		this->margin = margin;
+	}
+
+	int32_t DynamicAabbTree::createProxy(const AxisAlignedBoundingBox& bounds, EntityHandle entity)
+	{
+		int32_t proxy = this->allocateNode();
+
+		Node& node = this->nodes[proxy];
+		node.leaf_bounds = bounds;
+		node.bounds = AxisAlignedBoundingBox(bounds.min - vector3F(this->margin), bounds.max + vector3F(this->margin));
+		node.entity = entity;
+		node.height = 0;
+
+		this->insertLeaf(proxy);
+		this->proxy_count++;
+		return proxy;
+	}
+
+	void DynamicAabbTree::destroyProxy(int32_t proxy)
+	{
+		GENESIS_ENGINE_ASSERT(proxy >= 0 && proxy < (int32_t)this->nodes.size() && this->nodes[proxy].isLeaf(), "Invalid proxy");
+
+		this->removeLeaf(proxy);
+		this->freeNode(proxy);
+		this->proxy_count--;
+	}
+
+	bool DynamicAabbTree::moveProxy(int32_t proxy, const AxisAlignedBoundingBox& bounds)
+	{
+		GENESIS_ENGINE_ASSERT(proxy >= 0 && proxy < (int32_t)this->nodes.size() && this->nodes[proxy].isLeaf(), "Invalid proxy");
+
+		Node& node = this->nodes[proxy];
+		node.leaf_bounds = bounds;
+
+		if (node.bounds.contains(bounds))
+		{
+			return false;
+		}
+
+		this->removeLeaf(proxy);
+		this->nodes[proxy].bounds = AxisAlignedBoundingBox(bounds.min - vector3F(this->margin), bounds.max + vector3F(this->margin));
+		this->insertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAabbTree::clear()
+	{
+		this->nodes.clear();
+		this->root = null_node;
+		this->free_list = null_node;
+		this->proxy_count = 0;
+	}
+
+	int32_t DynamicAabbTree::allocateNode()
+	{
+		if (this->free_list == null_node)
+		{
+			this->nodes.emplace_back();
+			return (int32_t)this->nodes.size() - 1;
+		}
+
+		int32_t node = this->free_list;
+		this->free_list = this->nodes[node].parent;
+		this->nodes[node] = Node();
+		return node;
+	}
+
+	void DynamicAabbTree::freeNode(int32_t node)
+	{
+		this->nodes[node].parent = this->free_list;
+		this->nodes[node].child1 = null_node;
+		this->nodes[node].child2 = null_node;
+		this->nodes[node].height = -1;
+		this->free_list = node;
+	}
+
+	void DynamicAabbTree::insertLeaf(int32_t leaf)
+	{
+		if (this->root == null_node)
+		{
+			this->root = leaf;
+			this->nodes[leaf].parent = null_node;
+			return;
+		}
+
+		//Walk down to the sibling that makes the cheapest surface area increase
+		const AxisAlignedBoundingBox leaf_bounds = this->nodes[leaf].bounds;
+		int32_t index = this->root;
+		while (!this->nodes[index].isLeaf())
+		{
+			const Node& node = this->nodes[index];
+			const float area = node.bounds.getSurfaceArea();
+			const float combined_area = AxisAlignedBoundingBox::merge(node.bounds, leaf_bounds).getSurfaceArea();
+
+			//Cost of making a new parent for this node and the leaf, and the minimum cost pushed down to the children
+			const float cost = 2.0f * combined_area;
+			const float inheritance_cost = 2.0f * (combined_area - area);
+
+			auto child_cost = [&](int32_t child)
+			{
+				const Node& child_node = this->nodes[child];
+				const float new_area = AxisAlignedBoundingBox::merge(child_node.bounds, leaf_bounds).getSurfaceArea();
+				return child_node.isLeaf() ? (new_area + inheritance_cost) : ((new_area - child_node.bounds.getSurfaceArea()) + inheritance_cost);
+			};
+
+			const float cost1 = child_cost(node.child1);
+			const float cost2 = child_cost(node.child2);
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = (cost1 < cost2) ? node.child1 : node.child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t old_parent = this->nodes[sibling].parent;
+		const int32_t new_parent = this->allocateNode();
+		this->nodes[new_parent].parent = old_parent;
+		this->nodes[new_parent].bounds = AxisAlignedBoundingBox::merge(leaf_bounds, this->nodes[sibling].bounds);
+		this->nodes[new_parent].height = this->nodes[sibling].height + 1;
+		this->nodes[new_parent].child1 = sibling;
+		this->nodes[new_parent].child2 = leaf;
+		this->nodes[sibling].parent = new_parent;
+		this->nodes[leaf].parent = new_parent;
+
+		if (old_parent != null_node)
+		{
+			if (this->nodes[old_parent].child1 == sibling)
+			{
+				this->nodes[old_parent].child1 = new_parent;
+			}
+			else
+			{
+				this->nodes[old_parent].child2 = new_parent;
+			}
+		}
+		else
+		{
+			this->root = new_parent;
+		}
+
+		//Refit and rebalance back up to the root
+		index = this->nodes[leaf].parent;
+		while (index != null_node)
+		{
+			index = this->balance(index);
+
+			Node& node = this->nodes[index];
+			node.height = 1 + std::max(this->nodes[node.child1].height, this->nodes[node.child2].height);
+			node.bounds = AxisAlignedBoundingBox::merge(this->nodes[node.child1].bounds, this->nodes[node.child2].bounds);
+
+			index = node.parent;
+		}
+	}
+
+	void DynamicAabbTree::removeLeaf(int32_t leaf)
+	{
+		if (leaf == this->root)
+		{
+			this->root = null_node;
+			return;
+		}
+
+		const int32_t parent = this->nodes[leaf].parent;
+		const int32_t grand_parent = this->nodes[parent].parent;
+		const int32_t sibling = (this->nodes[parent].child1 == leaf) ? this->nodes[parent].child2 : this->nodes[parent].child1;
+
+		if (grand_parent == null_node)
+		{
+			this->root = sibling;
+			this->nodes[sibling].parent = null_node;
+			this->freeNode(parent);
+			return;
+		}
+
+		//The sibling takes the parent's place
+		if (this->nodes[grand_parent].child1 == parent)
+		{
+			this->nodes[grand_parent].child1 = sibling;
+		}
+		else
+		{
+			this->nodes[grand_parent].child2 = sibling;
+		}
+		this->nodes[sibling].parent = grand_parent;
+		this->freeNode(parent);
+
+		int32_t index = grand_parent;
+		while (index != null_node)
+		{
+			index = this->balance(index);
+
+			Node& node = this->nodes[index];
+			node.height = 1 + std::max(this->nodes[node.child1].height, this->nodes[node.child2].height);
+			node.bounds = AxisAlignedBoundingBox::merge(this->nodes[node.child1].bounds, this->nodes[node.child2].bounds);
+
+			index = node.parent;
+		}
+	}
+
+	int32_t DynamicAabbTree::balance(int32_t a_index)
+	{
+		//Rotates the taller child up if the two sides differ by more than one, returns the index now at this position
+		Node& a = this->nodes[a_index];
+		if (a.isLeaf() || a.height < 2)
+		{
+			return a_index;
+		}
+
+		const int32_t b_index = a.child1;
+		const int32_t c_index = a.child2;
+		const int32_t height_difference = this->nodes[c_index].height - this->nodes[b_index].height;
+
+		if (height_difference > 1 || height_difference < -1)
+		{
+			//up is the taller child that gets rotated up, down is the other one
+			const bool rotate_c = height_difference > 1;
+			const int32_t up_index = rotate_c ? c_index : b_index;
+			const int32_t down_index = rotate_c ? b_index : c_index;
+
+			Node& up = this->nodes[up_index];
+			const int32_t f_index = up.child1;
+			const int32_t g_index = up.child2;
+			Node& f = this->nodes[f_index];
+			Node& g = this->nodes[g_index];
+			Node& down = this->nodes[down_index];
+
+			//Swap a and up
+			up.child1 = a_index;
+			up.parent = a.parent;
+			a.parent = up_index;
+
+			if (up.parent != null_node)
+			{
+				if (this->nodes[up.parent].child1 == a_index)
+				{
+					this->nodes[up.parent].child1 = up_index;
+				}
+				else
+				{
+					this->nodes[up.parent].child2 = up_index;
+				}
+			}
+			else
+			{
+				this->root = up_index;
+			}
+
+			//The taller grandchild stays with up, the shorter one moves down to a
+			const bool keep_f = f.height > g.height;
+			const int32_t keep_index = keep_f ? f_index : g_index;
+			const int32_t move_index = keep_f ? g_index : f_index;
+			Node& keep = this->nodes[keep_index];
+			Node& move = this->nodes[move_index];
+
+			up.child2 = keep_index;
+			if (rotate_c)
+			{
+				a.child2 = move_index;
+			}
+			else
+			{
+				a.child1 = move_index;
+			}
+			move.parent = a_index;
+
+			a.bounds = AxisAlignedBoundingBox::merge(down.bounds, move.bounds);
+			up.bounds = AxisAlignedBoundingBox::merge(a.bounds, keep.bounds);
+			a.height = 1 + std::max(down.height, move.height);
+			up.height = 1 + std::max(a.height, keep.height);
+
+			return up_index;
+		}
+
+		return a_index;
+	}
+}
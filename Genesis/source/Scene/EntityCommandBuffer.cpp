@@ -0,0 +1,148 @@
+#include "Genesis/Scene/EntityCommandBuffer.hpp"
+
+#include "Genesis/Component/NameComponent.hpp"
+#include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Job/JobSystem.hpp"
+
+namespace Genesis
+{
+	CommandEntity EntityCommandBuffer::createEntity()
+	{
+		this->command_count++;
+
+		CommandEntity entity;
+		entity.created_index = this->created_count++;
+		return entity;
+	}
+
+	CommandEntity EntityCommandBuffer::createEntity(const char* name)
+	{
+		CommandEntity entity = this->createEntity();
+		this->addComponent<NameComponent>(entity, name);
+		return entity;
+	}
+
+	void EntityCommandBuffer::destroyEntity(CommandEntity entity)
+	{
+		this->command_count++;
+		this->destroyed_entities.push_back(entity);
+	}
+
+	void EntityCommandBuffer::addChild(CommandEntity parent, CommandEntity child)
+	{
+		this->command_count++;
+		this->parent_commands.push_back({ parent, child, true });
+	}
+
+	void EntityCommandBuffer::removeChild(CommandEntity parent, CommandEntity child)
+	{
+		this->command_count++;
+		this->parent_commands.push_back({ parent, child, false });
+	}
+
+	void EntityCommandBuffer::playback(Scene* scene)
+	{
+		GENESIS_PROFILE_FUNCTION("EntityCommandBuffer::playback");
+
+		if (this->empty())
+		{
+			return;
+		}
+
+		EntityRegistry& registry = scene->registry;
+
+		this->created_entities.resize(this->created_count);
+		registry.create(this->created_entities.begin(), this->created_entities.end());
+
+		for (auto& commands : this->component_commands)
+		{
+			commands->playbackAdds(registry, this->created_entities);
+		}
+
+		for (ParentCommand& command : this->parent_commands)
+		{
+			EntityHandle parent = EntityCommandBuffer::resolve(command.parent, this->created_entities);
+			EntityHandle child = EntityCommandBuffer::resolve(command.child, this->created_entities);
+			if (registry.valid(parent) && registry.valid(child))
+			{
+				if (command.add)
+				{
+					HierarchyUtils::addChild(registry, parent, child);
+				}
+				else
+				{
+					HierarchyUtils::removeChild(registry, parent, child);
+				}
+			}
+		}
+
+		for (auto& commands : this->component_commands)
+		{
+			commands->playbackRemoves(registry, this->created_entities);
+		}
+
+		//An entity may already be gone if its parent was destroyed first
+		for (CommandEntity command_entity : this->destroyed_entities)
+		{
+			EntityHandle entity = EntityCommandBuffer::resolve(command_entity, this->created_entities);
+			if (registry.valid(entity))
+			{
+				scene->destoryEntity(Entity(scene, entity));
+			}
+		}
+
+		this->clear();
+	}
+
+	void EntityCommandBuffer::clear()
+	{
+		this->command_count = 0;
+		this->created_count = 0;
+		this->parent_commands.clear();
+		this->destroyed_entities.clear();
+		this->created_entities.clear();
+
+		for (auto& commands : this->component_commands)
+		{
+			commands->clear();
+		}
+	}
+
+	EntityHandle EntityCommandBuffer::resolve(CommandEntity entity, const vector<EntityHandle>& created_entities)
+	{
+		if (entity.created_index != CommandEntity::not_created)
+		{
+			GENESIS_ENGINE_ASSERT(entity.created_index < created_entities.size(), "CommandEntity was created by a different command buffer");
+			return created_entities[entity.created_index];
+		}
+
+		return entity.handle;
+	}
+
+	EntityCommandBuffers::EntityCommandBuffers(JobSystem* job_system)
+	{
+		this->job_system = job_system;
+
+		//Job threads plus one slot for the main thread, nothing else outside the pool should record
+		const size_t buffer_count = (job_system != nullptr) ? (job_system->getNumberOfJobThreads() + 1) : 1;
+		this->buffers.resize(buffer_count);
+	}
+
+	EntityCommandBuffer& EntityCommandBuffers::get()
+	{
+		if (this->job_system == nullptr)
+		{
+			return this->buffers[0];
+		}
+
+		return this->buffers[this->job_system->getCurrentThreadId()];
+	}
+
+	void EntityCommandBuffers::playback(Scene* scene)
+	{
+		for (EntityCommandBuffer& buffer : this->buffers)
+		{
+			buffer.playback(scene);
+		}
+	}
+}
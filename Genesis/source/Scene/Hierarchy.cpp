@@ -6,32 +6,33 @@ namespace Genesis
 	{
 		GENESIS_ENGINE_ASSERT(registry.valid(parent), "Parent not valid");
 		GENESIS_ENGINE_ASSERT(registry.valid(child), "Child not valid");
+		GENESIS_ENGINE_ASSERT(parent != child, "Entity can't be its own child");
+
+		ChildNode* old_child_node = registry.try_get<ChildNode>(child);
+		if (old_child_node != nullptr && old_child_node->parent != null_entity)
+		{
+			HierarchyUtils::removeChild(registry, old_child_node->parent, child);
+		}
 
 		ParentNode& parent_node = registry.get_or_emplace<ParentNode>(parent);
 		ChildNode& child_node = registry.get_or_emplace<ChildNode>(child);
+		HierarchyUtils::markChanged(registry);
 
-		child_node.prev = null_entity;
+		child_node.prev = parent_node.last;
 		child_node.next = null_entity;
 		child_node.parent = parent;
 
-		if (parent_node.first == null_entity)
+		if (parent_node.last == null_entity)
 		{
 			parent_node.first = child;
 		}
 		else
 		{
-			// get last child
-			auto prev_entity = parent_node.first;
-			auto current_hierarchy = registry.try_get<ChildNode>(prev_entity);
-			while (current_hierarchy != nullptr && current_hierarchy->next != null_entity)
-			{
-				prev_entity = current_hierarchy->next;
-				current_hierarchy = registry.try_get<ChildNode>(prev_entity);
-			}
-			// add new
-			current_hierarchy->next = child;
-			child_node.prev = prev_entity;
+			registry.get<ChildNode>(parent_node.last).next = child;
 		}
+
+		parent_node.last = child;
+		parent_node.child_count++;
 	}
 
 	void HierarchyUtils::removeChild(EntityRegistry& registry, EntityHandle parent, EntityHandle child)
@@ -43,38 +44,111 @@ namespace Genesis
 
 		ParentNode& parent_node = registry.get<ParentNode>(parent);
 		ChildNode& child_node = registry.get<ChildNode>(child);
+		GENESIS_ENGINE_ASSERT(child_node.parent == parent, "Child belongs to a different parent");
 
-		if (child_node.prev == entt::null || !registry.valid(child_node.prev))
+		if (child_node.prev == null_entity)
 		{
 			parent_node.first = child_node.next;
+		}
+		else
+		{
+			registry.get<ChildNode>(child_node.prev).next = child_node.next;
+		}
 
-			if (child_node.next != null_entity)
-			{
-				auto next_hierarchy = registry.try_get<ChildNode>(child_node.next);
-				if (next_hierarchy != nullptr)
-				{
-					next_hierarchy->prev = null_entity;
-				}
-			}
+		if (child_node.next == null_entity)
+		{
+			parent_node.last = child_node.prev;
 		}
 		else
 		{
-			auto prev_hierarchy = registry.try_get<ChildNode>(child_node.prev);
-			if (prev_hierarchy != nullptr)
+			registry.get<ChildNode>(child_node.next).prev = child_node.prev;
+		}
+
+		parent_node.child_count--;
+
+		registry.remove<ChildNode>(child);
+		HierarchyUtils::markChanged(registry);
+	}
+
+	void HierarchyUtils::getSubtree(EntityRegistry& registry, EntityHandle entity, vector<EntityHandle>& entities)
+	{
+		size_t next = entities.size();
+		entities.push_back(entity);
+
+		for (; next < entities.size(); next++)
+		{
+			for (EntityHandle child : EntityHiearchy(&registry, entities[next]))
 			{
-				prev_hierarchy->next = child_node.next;
+				entities.push_back(child);
 			}
-			if (child_node.next != null_entity)
+		}
+	}
+
+	void HierarchyUtils::sortDepthFirst(EntityRegistry& registry)
+	{
+		GENESIS_PROFILE_FUNCTION("HierarchyUtils::sortDepthFirst");
+
+		//Children are numbered together when their parent is visited, then visited first to last
+		flat_hash_map<EntityHandle, uint32_t> order;
+		order.reserve(registry.size<ChildNode>());
+
+		vector<EntityHandle> stack;
+		vector<EntityHandle> children;
+		auto roots = registry.view<ParentNode>(entt::exclude_t<ChildNode>());
+		for (EntityHandle root : roots)
+		{
+			stack.push_back(root);
+			while (!stack.empty())
 			{
-				auto next_hierarchy = registry.try_get<ChildNode>(child_node.next);
-				if (next_hierarchy != nullptr)
+				EntityHandle entity = stack.back();
+				stack.pop_back();
+
+				children.clear();
+				for (EntityHandle child : EntityHiearchy(&registry, entity))
 				{
-					next_hierarchy->prev = child_node.prev;
+					order[child] = (uint32_t)order.size();
+					children.push_back(child);
 				}
+
+				stack.insert(stack.end(), children.rbegin(), children.rend());
 			}
 		}
 
-		registry.remove<ChildNode>(child);
+		registry.sort<ChildNode>([&order](const EntityHandle lhs, const EntityHandle rhs)
+		{
+			auto lhs_iterator = order.find(lhs);
+			auto rhs_iterator = order.find(rhs);
+			const uint32_t lhs_order = (lhs_iterator != order.end()) ? lhs_iterator->second : UINT32_MAX;
+			const uint32_t rhs_order = (rhs_iterator != order.end()) ? rhs_iterator->second : UINT32_MAX;
+			return lhs_order < rhs_order;
+		});
+
+		HierarchyVersion& version = registry.ctx_or_set<HierarchyVersion>();
+		version.sorted_version = version.version;
+	}
+
+	void HierarchyUtils::sortDepthFirstIfNeeded(EntityRegistry& registry, uint64_t min_changes)
+	{
+		HierarchyVersion& version = registry.ctx_or_set<HierarchyVersion>();
+		if ((version.version - version.sorted_version) >= min_changes)
+		{
+			HierarchyUtils::sortDepthFirst(registry);
+		}
+	}
+
+	void HierarchyUtils::markChanged(EntityRegistry& registry)
+	{
+		registry.ctx_or_set<HierarchyVersion>().version++;
+	}
+
+	uint64_t HierarchyUtils::getVersion(EntityRegistry& registry)
+	{
+		return registry.ctx_or_set<HierarchyVersion>().version;
+	}
+
+	void HierarchyUtils::onHierarchyChanged(EntityRegistry& registry, EntityHandle entity)
+	{
+		HierarchyUtils::markChanged(registry);
 	}
 
 	HiearchyIterator::HiearchyIterator(EntityRegistry* registry, EntityHandle child)
@@ -2,6 +2,7 @@
 
 #include "Genesis/Component/NameComponent.hpp"
 #include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Scene/SceneSnapshot.hpp"
 
 //TEMP
 #include "Genesis/Component/TransformComponent.hpp"
@@ -25,12 +26,25 @@ namespace Genesis
 
 	void Scene::destoryEntity(Entity entity)
 	{
-		for (EntityHandle child : entity.children())
+		EntityHandle handle = entity.handle();
+
+		//Only the top of the subtree needs unlinking, everything under it goes at once
+		ChildNode* child_node = this->registry.try_get<ChildNode>(handle);
+		if (child_node != nullptr && child_node->parent != null_entity)
 		{
-			this->destoryEntity(Entity(this, child));
+			HierarchyUtils::removeChild(this->registry, child_node->parent, handle);
 		}
 
-		this->registry.destroy(entity.handle());
+		vector<EntityHandle> subtree;
+		HierarchyUtils::getSubtree(this->registry, handle, subtree);
+		this->registry.destroy(subtree.begin(), subtree.end());
+	}
+
+	Scene* Scene::clone()
+	{
+		Scene* scene = new Scene();
+		SceneSnapshot::copyScene(this, scene);
+		return scene;
 	}
 
 	void Scene::addChild(Entity parent, Entity child)
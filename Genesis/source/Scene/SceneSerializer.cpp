@@ -13,6 +13,7 @@
 #include "Genesis/Component/PhysicsComponents.hpp"
 
 #include "Genesis/Resource/ResourceManager.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
 
 namespace Genesis
 {
@@ -128,6 +129,7 @@ namespace Genesis
 			transform.setPosition(transform_node["Position"].as<vector3D>());
 			transform.setOrientation(transform_node["Orientation"].as<quaternionD>());
 			transform.setScale(transform_node["Scale"].as<vector3D>());
+			TransformResolveSystem::markDirty(scene->registry, entity.handle());
 		}
 
 		if (entity_node["Model"])
@@ -201,6 +203,24 @@ namespace Genesis
 		return entity;
 	}
 
+	void getEntityResources(const YAML::Node& entity_node, vector<string>& mesh_names, vector<string>& material_names)
+	{
+		if (entity_node["Model"])
+		{
+			const YAML::Node model_node = entity_node["Model"];
+			mesh_names.push_back(model_node["Mesh"].as<std::string>());
+			material_names.push_back(model_node["Material"].as<std::string>());
+		}
+
+		if (entity_node["Children"])
+		{
+			for (const YAML::Node child : entity_node["Children"])
+			{
+				getEntityResources(child, mesh_names, material_names);
+			}
+		}
+	}
+
 	void SceneSerializer::serialize(Scene* scene, const char* file_path)
 	{
 		YAML::Node scene_node;
@@ -225,7 +245,7 @@ namespace Genesis
 			{
 				if (!scene->registry.has<ChildNode>(entity))
 				{
-					scene_node["Entities"].push_back(serializeEntity(Entity(scene, entity)));
+					scene_node["Entities"].push_back(Genesis::serializeEntity(Entity(scene, entity)));
 				}
 			}
 		});
@@ -252,10 +272,22 @@ namespace Genesis
 			auto entities = scene_node["Entities"];
 			for (auto entity : entities)
 			{
-				deserializeEntity(entity, scene, resource_manager);
+				Genesis::deserializeEntity(entity, scene, resource_manager);
 			}
 		}
 
 		return scene;
 	}
-}
\ No newline at end of file
+
+	void SceneSerializer::serializeEntity(Entity entity, const char* file_path)
+	{
+		std::ofstream file_out(file_path);
+		file_out << Genesis::serializeEntity(entity);
+	}
+
+	Entity SceneSerializer::deserializeEntity(const char* file_path, Scene* scene, ResourceManager* resource_manager)
+	{
+		YAML::Node entity_node = YAML::LoadFile(file_path);
+		return Genesis::deserializeEntity(entity_node, scene, resource_manager);
+	}
+}
@@ -0,0 +1,145 @@
+#include "Genesis/Scene/SceneSnapshot.hpp"
+
+#include "Genesis/Scene/Hierarchy.hpp"
+#include "Genesis/Component/NameComponent.hpp"
+#include "Genesis/Component/TransformComponent.hpp"
+#include "Genesis/Component/ModelComponent.hpp"
+#include "Genesis/Component/PhysicsComponents.hpp"
+#include "Genesis/Rendering/Camera.hpp"
+#include "Genesis/Rendering/Lights.hpp"
+#include "Genesis/Physics/RigidBody.hpp"
+#include "Genesis/Physics/CollisionShape.hpp"
+#include "Genesis/Physics/PhysicsWorld.hpp"
+
+namespace Genesis
+{
+	//Physics objects belong to one world, so copies only take the settings and initialize_scene creates new ones
+	static void copyRigidBodies(EntityRegistry& source, EntityRegistry& destination)
+	{
+		auto view = source.view<RigidBody>();
+		for (EntityHandle entity : view)
+		{
+			RigidBody& source_body = view.get(entity);
+			RigidBody& body = destination.emplace<RigidBody>(entity);
+			body.setType(source_body.getType());
+			body.setMass(source_body.getMass());
+			body.setGravityEnabled(source_body.getGravityEnabled());
+			body.setIsAllowedToSleep(source_body.getIsAllowedToSleep());
+			body.setLinearVelocity(source_body.getLinearVelocity());
+			body.setAngularVelocity(source_body.getAngularVelocity());
+		}
+	}
+
+	static void copyCollisionShapes(EntityRegistry& source, EntityRegistry& destination)
+	{
+		auto view = source.view<CollisionShape>();
+		for (EntityHandle entity : view)
+		{
+			CollisionShape& shape = destination.emplace<CollisionShape>(entity, view.get(entity));
+			shape.shape = nullptr;
+			shape.proxy = nullptr;
+		}
+	}
+
+	static void copyPhysicsWorlds(EntityRegistry& source, EntityRegistry& destination)
+	{
+		auto view = source.view<PhysicsWorld>();
+		for (EntityHandle entity : view)
+		{
+			destination.emplace<PhysicsWorld>(entity, view.get(entity).getGravity());
+		}
+	}
+
+	static vector<std::pair<size_t, SceneSnapshot::CopyFunction>>& getCopyFunctions()
+	{
+		static vector<std::pair<size_t, SceneSnapshot::CopyFunction>> copy_functions =
+		{
+			{ TypeInfo<NameComponent>::getHash(), &SceneSnapshot::copyPool<NameComponent> },
+			{ TypeInfo<Transform>::getHash(), &SceneSnapshot::copyPool<Transform> },
+			{ TypeInfo<RootTransform>::getHash(), &SceneSnapshot::copyPool<RootTransform> },
+			{ TypeInfo<WorldTransform>::getHash(), &SceneSnapshot::copyPool<WorldTransform> },
+			{ TypeInfo<TransformDirty>::getHash(), &SceneSnapshot::copyPool<TransformDirty> },
+			{ TypeInfo<ParentNode>::getHash(), &SceneSnapshot::copyPool<ParentNode> },
+			{ TypeInfo<ChildNode>::getHash(), &SceneSnapshot::copyPool<ChildNode> },
+			{ TypeInfo<ModelComponent>::getHash(), &SceneSnapshot::copyPool<ModelComponent> },
+			{ TypeInfo<Camera>::getHash(), &SceneSnapshot::copyPool<Camera> },
+			{ TypeInfo<DirectionalLight>::getHash(), &SceneSnapshot::copyPool<DirectionalLight> },
+			{ TypeInfo<PointLight>::getHash(), &SceneSnapshot::copyPool<PointLight> },
+			{ TypeInfo<SpotLight>::getHash(), &SceneSnapshot::copyPool<SpotLight> },
+			{ TypeInfo<RigidBodyTemplate>::getHash(), &SceneSnapshot::copyPool<RigidBodyTemplate> },
+			{ TypeInfo<CollisionShapeTemplate>::getHash(), &SceneSnapshot::copyPool<CollisionShapeTemplate> },
+			{ TypeInfo<TriggerShapeTemplate>::getHash(), &SceneSnapshot::copyPool<TriggerShapeTemplate> },
+			{ TypeInfo<RigidBody>::getHash(), &copyRigidBodies },
+			{ TypeInfo<CollisionShape>::getHash(), &copyCollisionShapes },
+			{ TypeInfo<PhysicsWorld>::getHash(), &copyPhysicsWorlds },
+		};
+
+		return copy_functions;
+	}
+
+	void SceneSnapshot::registerComponent(size_t type_hash, CopyFunction copy_function)
+	{
+		auto& copy_functions = getCopyFunctions();
+		for (auto& pair : copy_functions)
+		{
+			if (pair.first == type_hash)
+			{
+				pair.second = copy_function;
+				return;
+			}
+		}
+
+		copy_functions.push_back({ type_hash, copy_function });
+	}
+
+	void SceneSnapshot::copyScene(Scene* source, Scene* destination)
+	{
+		GENESIS_PROFILE_FUNCTION("SceneSnapshot::copyScene");
+
+		//A fresh registry also drops any context data and signal connections, systems set those up again on their next run
+		destination->registry = EntityRegistry();
+
+		//Recreated in index order so every create lands at the end of the entity list, skipped indices just go on the free list
+		vector<EntityHandle> entities;
+		entities.reserve(source->registry.size());
+		source->registry.each([&](EntityHandle entity)
+		{
+			entities.push_back(entity);
+		});
+
+		std::sort(entities.begin(), entities.end(), [&](EntityHandle lhs, EntityHandle rhs)
+		{
+			return EntityRegistry::entity(lhs) < EntityRegistry::entity(rhs);
+		});
+
+		for (EntityHandle entity : entities)
+		{
+			EntityHandle created = destination->registry.create(entity);
+			GENESIS_ENGINE_ASSERT(created == entity, "Scene copy failed to recreate an entity");
+		}
+
+		for (auto& pair : getCopyFunctions())
+		{
+			pair.second(source->registry, destination->registry);
+		}
+
+		destination->scene_components = SceneComponents(&destination->registry, source->scene_components.handle());
+		destination->lighting_settings = source->lighting_settings;
+	}
+
+	void SceneSnapshot::capture(Scene* scene)
+	{
+		if (!this->snapshot)
+		{
+			this->snapshot = std::make_unique<Scene>();
+		}
+
+		SceneSnapshot::copyScene(scene, this->snapshot.get());
+	}
+
+	void SceneSnapshot::restore(Scene* scene)
+	{
+		GENESIS_ENGINE_ASSERT(this->snapshot, "Nothing captured to restore");
+		SceneSnapshot::copyScene(this->snapshot.get(), scene);
+	}
+}
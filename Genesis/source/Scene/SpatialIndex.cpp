@@ -0,0 +1,101 @@
+#include "Genesis/Scene/SpatialIndex.hpp"
+
+namespace Genesis
+{
+	void SpatialIndex::insertOrUpdate(EntityHandle entity, const AxisAlignedBoundingBox& bounds)
+	{
+		auto iterator = this->proxies.find(entity);
+		if (iterator != this->proxies.end())
+		{
+			this->tree.moveProxy(iterator->second, bounds);
+		}
+		else
+		{
+			this->proxies[entity] = this->tree.createProxy(bounds, entity);
+		}
+	}
+
+	void SpatialIndex::remove(EntityHandle entity)
+	{
+		auto iterator = this->proxies.find(entity);
+		if (iterator != this->proxies.end())
+		{
+			this->tree.destroyProxy(iterator->second);
+			this->proxies.erase(iterator);
+		}
+	}
+
+	void SpatialIndex::clear()
+	{
+		this->tree.clear();
+		this->proxies.clear();
+	}
+
+	void SpatialIndex::queryAabb(const AxisAlignedBoundingBox& bounds, vector<EntityHandle>& results) const
+	{
+		this->tree.query([&](const AxisAlignedBoundingBox& node_bounds)
+		{
+			return node_bounds.overlaps(bounds);
+		},
+		[&](EntityHandle entity, const AxisAlignedBoundingBox& entity_bounds)
+		{
+			results.push_back(entity);
+			return true;
+		});
+	}
+
+	void SpatialIndex::querySphere(const vector3F& center, float radius, vector<EntityHandle>& results) const
+	{
+		this->tree.query([&](const AxisAlignedBoundingBox& node_bounds)
+		{
+			return node_bounds.overlapsSphere(center, radius);
+		},
+		[&](EntityHandle entity, const AxisAlignedBoundingBox& entity_bounds)
+		{
+			results.push_back(entity);
+			return true;
+		});
+	}
+
+	void SpatialIndex::queryFrustum(const Frustum& frustum, vector<EntityHandle>& results) const
+	{
+		this->tree.query([&](const AxisAlignedBoundingBox& node_bounds)
+		{
+			return frustum.aabbTest(node_bounds.min, node_bounds.max);
+		},
+		[&](EntityHandle entity, const AxisAlignedBoundingBox& entity_bounds)
+		{
+			results.push_back(entity);
+			return true;
+		});
+	}
+
+	void SpatialIndex::raycast(const vector3F& origin, const vector3F& direction, float max_distance, vector<EntityHandle>& results) const
+	{
+		const vector3F inverse_direction = 1.0f / direction;
+
+		vector<std::pair<float, EntityHandle>> hits;
+		this->tree.query([&](const AxisAlignedBoundingBox& node_bounds)
+		{
+			float hit_distance;
+			return node_bounds.intersectsRay(origin, inverse_direction, max_distance, hit_distance);
+		},
+		[&](EntityHandle entity, const AxisAlignedBoundingBox& entity_bounds)
+		{
+			float hit_distance;
+			entity_bounds.intersectsRay(origin, inverse_direction, max_distance, hit_distance);
+			hits.push_back({ hit_distance, entity });
+			return true;
+		});
+
+		std::sort(hits.begin(), hits.end(), [](const std::pair<float, EntityHandle>& lhs, const std::pair<float, EntityHandle>& rhs)
+		{
+			return lhs.first < rhs.first;
+		});
+
+		for (auto& hit : hits)
+		{
+			results.push_back(hit.second);
+		}
+	}
+}
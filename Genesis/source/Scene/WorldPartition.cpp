@@ -0,0 +1,539 @@
+#include "Genesis/Scene/WorldPartition.hpp"
+
+#include <fstream>
+#include "Genesis/Core/Yaml.hpp"
+
+#include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Scene/SceneSerializer.hpp"
+#include "Genesis/Component/TransformComponent.hpp"
+#include "Genesis/Resource/ResourceManager.hpp"
+
+namespace Genesis
+{
+	enum class CellState
+	{
+		Unloaded,
+		Parsing,
+		Reading,
+		Uploading,
+		Parsed,
+		Loaded,
+	};
+
+	struct WorldPartition::Cell
+	{
+		vector2I coord;
+		string file_path;
+
+		CellState state = CellState::Unloaded;
+
+		//False once the focus moves away, a cell that's still parsing is dropped when the job finishes
+		bool wanted = false;
+		double distance = 0.0;
+
+		//Written by the parse and read jobs, only touched by the main thread once job_finished is set
+		//Always rebound with reset, assigning a Node writes through to whatever it already refers to
+		YAML::Node entities;
+		std::atomic<bool> job_finished{ false };
+
+		//Found by the parse job, the main thread then drops the ones the pools already have so only new resources are read
+		vector<string> mesh_names;
+		vector<string> material_names;
+
+		//Read from disk by the read job, uploaded on the main thread a few at a time
+		vector<std::pair<string, MeshData>> mesh_data;
+		vector<std::pair<string, YAML::Node>> material_data;
+		vector<std::pair<string, TextureData>> texture_data;
+
+		//Keeps everything the entities use alive until they have been created, the pools only hold weak references
+		vector<shared_ptr<Mesh>> meshes;
+		vector<shared_ptr<Material>> materials;
+		vector<shared_ptr<Texture>> textures;
+
+		size_t next_entity = 0;
+		vector<EntityHandle> roots;
+	};
+
+	template<typename T>
+	static void removeDuplicates(vector<T>& values)
+	{
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+	}
+
+	//Cell files are named after the world file so several worlds can share a directory
+	static string getCellFilename(const string& world_filename, const vector2I& coord)
+	{
+		const size_t extention_index = world_filename.find_last_of('.');
+		const string stem = (extention_index != string::npos) ? world_filename.substr(0, extention_index) : world_filename;
+		return stem + "_" + std::to_string(coord.x) + "_" + std::to_string(coord.y) + ".cell";
+	}
+
+	//Dialogs give back windows paths, so both separators are checked
+	static string getDirectory(const string& file_path)
+	{
+		const size_t index = file_path.find_last_of("/\\");
+		return (index != string::npos) ? file_path.substr(0, index + 1) : "";
+	}
+
+	void WorldPartition::save(Scene* scene, const char* file_path, double cell_size)
+	{
+		GENESIS_ENGINE_ASSERT(cell_size > 0.0, "Cell size must be positive");
+
+		YAML::Node world_node;
+		world_node["cell_size"] = cell_size;
+
+		{
+			YAML::Node scene_info_node;
+			scene_info_node["ambient_light"] = scene->lighting_settings.ambient_light;
+			scene_info_node["gamma_correction"] = scene->lighting_settings.gamma_correction;
+			world_node["Lighting"] = scene_info_node;
+		}
+
+		flat_hash_map<vector2I, YAML::Node, CellHash> cell_nodes;
+		scene->registry.each([&](EntityHandle entity)
+		{
+			if (entity == scene->scene_components.handle() || scene->registry.has<ChildNode>(entity))
+			{
+				return;
+			}
+
+			YAML::Node entity_node = serializeEntity(Entity(scene, entity));
+			if (Transform* transform = scene->registry.try_get<Transform>(entity))
+			{
+				const vector3D position = transform->getPosition();
+				const vector2I coord((int32_t)std::floor(position.x / cell_size), (int32_t)std::floor(position.z / cell_size));
+				cell_nodes[coord]["Entities"].push_back(entity_node);
+			}
+			else
+			{
+				world_node["Entities"].push_back(entity_node);
+			}
+		});
+
+		const string world_path = file_path;
+		const string directory = getDirectory(world_path);
+		const string world_filename = world_path.substr(directory.size());
+
+		for (auto& pair : cell_nodes)
+		{
+			const string cell_filename = getCellFilename(world_filename, pair.first);
+
+			YAML::Node cell_info_node;
+			cell_info_node["x"] = pair.first.x;
+			cell_info_node["z"] = pair.first.y;
+			cell_info_node["file"] = cell_filename;
+			world_node["Cells"].push_back(cell_info_node);
+
+			std::ofstream cell_out(directory + cell_filename);
+			cell_out << pair.second;
+		}
+
+		std::ofstream file_out(file_path);
+		file_out << world_node;
+	}
+
+	WorldPartition::WorldPartition(const char* file_path, Scene* scene, ResourceManager* resource_manager, JobSystem* job_system)
+	{
+		this->scene = scene;
+		this->resource_manager = resource_manager;
+		this->job_system = job_system;
+
+		YAML::Node world_node = YAML::LoadFile(file_path);
+		this->cell_size = world_node["cell_size"].as<double>();
+		GENESIS_ENGINE_ASSERT(this->cell_size > 0.0, "World file has an invalid cell size");
+
+		if (world_node["Lighting"])
+		{
+			YAML::Node scene_info_node = world_node["Lighting"];
+			scene->lighting_settings.ambient_light = scene_info_node["ambient_light"].as<vector3F>();
+			scene->lighting_settings.gamma_correction = scene_info_node["gamma_correction"].as<float>();
+		}
+
+		if (world_node["Entities"])
+		{
+			for (auto entity_node : world_node["Entities"])
+			{
+				deserializeEntity(entity_node, scene, resource_manager);
+			}
+		}
+
+		const string directory = getDirectory(file_path);
+		if (world_node["Cells"])
+		{
+			for (auto cell_info_node : world_node["Cells"])
+			{
+				std::unique_ptr<Cell> cell = std::make_unique<Cell>();
+				cell->coord = vector2I(cell_info_node["x"].as<int32_t>(), cell_info_node["z"].as<int32_t>());
+				cell->file_path = directory + cell_info_node["file"].as<string>();
+				this->cells[cell->coord] = std::move(cell);
+			}
+		}
+	}
+
+	WorldPartition::~WorldPartition()
+	{
+		//The jobs write into the cells, so they have to be done before the cells go away
+		if (this->job_system != nullptr)
+		{
+			//waitForCounter never runs background jobs, with a single job thread nothing else will
+			while (this->parse_counter.load(std::memory_order_acquire) != 0)
+			{
+				if (!this->job_system->runBackgroundJob())
+				{
+					this->job_system->waitForCounter(this->parse_counter);
+				}
+			}
+		}
+	}
+
+	void WorldPartition::update(const vector3D& focus_position)
+	{
+		GENESIS_PROFILE_FUNCTION("WorldPartition::update");
+
+		//Only the cells that could be in range are looked up, so large worlds don't cost anything to check
+		{
+			const vector2I min_coord = this->getCellCoord(focus_position - vector3D(this->load_radius));
+			const vector2I max_coord = this->getCellCoord(focus_position + vector3D(this->load_radius));
+			for (int32_t x = min_coord.x; x <= max_coord.x; x++)
+			{
+				for (int32_t z = min_coord.y; z <= max_coord.y; z++)
+				{
+					auto it = this->cells.find(vector2I(x, z));
+					if (it != this->cells.end())
+					{
+						Cell& cell = *it->second;
+						if (!cell.wanted && (this->getCellDistance(cell, focus_position) <= this->load_radius))
+						{
+							this->loadCell(cell);
+						}
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < this->resident_cells.size();)
+		{
+			Cell& cell = *this->resident_cells[i];
+			cell.distance = this->getCellDistance(cell, focus_position);
+
+			if (cell.distance > this->unload_radius)
+			{
+				cell.wanted = false;
+			}
+
+			const bool waiting_on_job = (cell.state == CellState::Parsing || cell.state == CellState::Reading);
+			if (waiting_on_job && cell.job_finished.load(std::memory_order_acquire))
+			{
+				if (cell.state == CellState::Parsing)
+				{
+					if (cell.wanted)
+					{
+						this->readCellResources(cell);
+					}
+					else
+					{
+						cell.state = CellState::Parsed;
+					}
+				}
+				else
+				{
+					cell.state = CellState::Uploading;
+				}
+			}
+
+			if (!cell.wanted && cell.state != CellState::Parsing && cell.state != CellState::Reading)
+			{
+				this->unloadCell(cell);
+				this->resident_cells[i] = this->resident_cells.back();
+				this->resident_cells.pop_back();
+				continue;
+			}
+
+			i++;
+		}
+
+		//Nearest cells fill in first
+		std::sort(this->resident_cells.begin(), this->resident_cells.end(), [](const Cell* lhs, const Cell* rhs)
+		{
+			return lhs->distance < rhs->distance;
+		});
+
+		using clock = std::chrono::high_resolution_clock;
+		const clock::time_point end_time = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(this->frame_budget_ms));
+
+		//Destroying first keeps the entity count from growing while moving through the world
+		while (!this->pending_destroy.empty())
+		{
+			const EntityHandle entity = this->pending_destroy.back();
+			this->pending_destroy.pop_back();
+
+			//May have already been deleted by something else
+			if (this->scene->registry.valid(entity))
+			{
+				this->scene->destoryEntity(Entity(this->scene, entity));
+			}
+
+			if (clock::now() >= end_time)
+			{
+				return;
+			}
+		}
+
+		for (Cell* cell : this->resident_cells)
+		{
+			if (cell->state == CellState::Uploading && !this->uploadCellResources(*cell, end_time))
+			{
+				return;
+			}
+
+			if (cell->state == CellState::Parsed && !this->instantiateCell(*cell, end_time))
+			{
+				return;
+			}
+		}
+	}
+
+	vector2I WorldPartition::getCellCoord(const vector3D& position) const
+	{
+		return vector2I((int32_t)std::floor(position.x / this->cell_size), (int32_t)std::floor(position.z / this->cell_size));
+	}
+
+	double WorldPartition::getCellDistance(const Cell& cell, const vector3D& position) const
+	{
+		const vector2D center = (vector2D(cell.coord) + vector2D(0.5)) * this->cell_size;
+		return glm::length(center - vector2D(position.x, position.z));
+	}
+
+	void WorldPartition::loadCell(Cell& cell)
+	{
+		cell.wanted = true;
+		if (cell.state != CellState::Unloaded)
+		{
+			return;
+		}
+
+		cell.state = CellState::Parsing;
+		cell.job_finished.store(false, std::memory_order_relaxed);
+		this->resident_cells.push_back(&cell);
+
+		Cell* cell_ptr = &cell;
+		auto parse = [cell_ptr](uint32_t thread_id)
+		{
+			//A missing or broken file just loads as an empty cell, the job can't let the exception escape
+			try
+			{
+				YAML::Node cell_node = YAML::LoadFile(cell_ptr->file_path);
+				cell_ptr->entities.reset(cell_node["Entities"]);
+
+				if (cell_ptr->entities.IsSequence())
+				{
+					for (const YAML::Node entity_node : cell_ptr->entities)
+					{
+						getEntityResources(entity_node, cell_ptr->mesh_names, cell_ptr->material_names);
+					}
+				}
+			}
+			catch (const YAML::Exception& exception)
+			{
+				GENESIS_ENGINE_ERROR("Failed to load world cell {}: {}", cell_ptr->file_path, exception.what());
+				cell_ptr->entities.reset();
+				cell_ptr->mesh_names.clear();
+				cell_ptr->material_names.clear();
+			}
+
+			removeDuplicates(cell_ptr->mesh_names);
+			removeDuplicates(cell_ptr->material_names);
+			cell_ptr->job_finished.store(true, std::memory_order_release);
+		};
+
+		if (this->job_system != nullptr)
+		{
+			this->job_system->addJob(parse, &this->parse_counter, JobPriority::Background);
+		}
+		else
+		{
+			parse(0);
+		}
+	}
+
+	void WorldPartition::readCellResources(Cell& cell)
+	{
+		//Anything the pools already have is held onto now, only the rest goes to the job
+		MeshPool& mesh_pool = this->resource_manager->mesh_pool;
+		MaterialPool& material_pool = this->resource_manager->material_pool;
+
+		auto take_loaded = [](auto& pool, vector<string>& names, auto& resources)
+		{
+			size_t unloaded_count = 0;
+			for (const string& name : names)
+			{
+				if (pool.hasResource(name))
+				{
+					resources.push_back(pool.getResource(name));
+				}
+				else
+				{
+					names[unloaded_count++] = name;
+				}
+			}
+			names.resize(unloaded_count);
+		};
+		take_loaded(mesh_pool, cell.mesh_names, cell.meshes);
+		take_loaded(material_pool, cell.material_names, cell.materials);
+
+		if (cell.mesh_names.empty() && cell.material_names.empty())
+		{
+			cell.state = CellState::Parsed;
+			return;
+		}
+
+		cell.state = CellState::Reading;
+		cell.job_finished.store(false, std::memory_order_relaxed);
+
+		//File reads and parsing only, the pools aren't thread safe and uploads have to happen on the main thread
+		//Textures can't be checked against the pool from here, ones that turn out to be loaded already are just dropped at upload
+		Cell* cell_ptr = &cell;
+		auto read = [cell_ptr](uint32_t thread_id)
+		{
+			for (const string& name : cell_ptr->mesh_names)
+			{
+				cell_ptr->mesh_data.emplace_back(name, ObjLoader::readMesh(name));
+			}
+
+			vector<string> texture_names;
+			for (const string& name : cell_ptr->material_names)
+			{
+				//A broken material is left for the pool to report when the entity asks for it
+				try
+				{
+					YAML::Node material_node = YAML::LoadFile(name);
+					MaterialPool::getTextureNames(material_node, texture_names);
+					cell_ptr->material_data.emplace_back(name, material_node);
+				}
+				catch (const YAML::Exception& exception)
+				{
+					GENESIS_ENGINE_ERROR("Failed to read material {}: {}", name, exception.what());
+				}
+			}
+
+			removeDuplicates(texture_names);
+			for (const string& name : texture_names)
+			{
+				TextureData texture = TexturePool::readTexture(name);
+				if (texture.pixels)
+				{
+					cell_ptr->texture_data.emplace_back(name, std::move(texture));
+				}
+			}
+
+			cell_ptr->mesh_names.clear();
+			cell_ptr->material_names.clear();
+			cell_ptr->job_finished.store(true, std::memory_order_release);
+		};
+
+		if (this->job_system != nullptr)
+		{
+			this->job_system->addJob(read, &this->parse_counter, JobPriority::Background);
+		}
+		else
+		{
+			read(0);
+		}
+	}
+
+	bool WorldPartition::uploadCellResources(Cell& cell, std::chrono::high_resolution_clock::time_point end_time)
+	{
+		//Textures first, so materials find them in the pool
+		while (!cell.texture_data.empty() || !cell.material_data.empty() || !cell.mesh_data.empty())
+		{
+			if (!cell.texture_data.empty())
+			{
+				auto& pair = cell.texture_data.back();
+				TexturePool& pool = this->resource_manager->texture_pool;
+				cell.textures.push_back(pool.hasResource(pair.first) ? pool.getResource(pair.first) : pool.createResource(pair.first, pair.second));
+				cell.texture_data.pop_back();
+			}
+			else if (!cell.material_data.empty())
+			{
+				auto& pair = cell.material_data.back();
+				MaterialPool& pool = this->resource_manager->material_pool;
+				cell.materials.push_back(pool.hasResource(pair.first) ? pool.getResource(pair.first) : pool.createResource(pair.first, pair.second));
+				cell.material_data.pop_back();
+			}
+			else
+			{
+				auto& pair = cell.mesh_data.back();
+				MeshPool& pool = this->resource_manager->mesh_pool;
+				cell.meshes.push_back(pool.hasResource(pair.first) ? pool.getResource(pair.first) : pool.createResource(pair.first, pair.second));
+				cell.mesh_data.pop_back();
+			}
+
+			if (std::chrono::high_resolution_clock::now() >= end_time)
+			{
+				break;
+			}
+		}
+
+		if (cell.texture_data.empty() && cell.material_data.empty() && cell.mesh_data.empty())
+		{
+			cell.state = CellState::Parsed;
+		}
+
+		return std::chrono::high_resolution_clock::now() < end_time;
+	}
+
+	void WorldPartition::unloadCell(Cell& cell)
+	{
+		GENESIS_ENGINE_ASSERT(cell.state != CellState::Parsing && cell.state != CellState::Reading, "Can't unload a cell while its job is running");
+
+		if (cell.state == CellState::Loaded)
+		{
+			this->loaded_cell_count--;
+		}
+
+		this->pending_destroy.insert(this->pending_destroy.end(), cell.roots.begin(), cell.roots.end());
+		cell.roots.clear();
+		cell.entities.reset();
+		cell.mesh_names.clear();
+		cell.material_names.clear();
+		cell.mesh_data.clear();
+		cell.material_data.clear();
+		cell.texture_data.clear();
+		cell.meshes.clear();
+		cell.materials.clear();
+		cell.textures.clear();
+		cell.next_entity = 0;
+		cell.wanted = false;
+		cell.state = CellState::Unloaded;
+	}
+
+	bool WorldPartition::instantiateCell(Cell& cell, std::chrono::high_resolution_clock::time_point end_time)
+	{
+		const size_t entity_count = cell.entities.IsSequence() ? cell.entities.size() : 0;
+		while (cell.next_entity < entity_count)
+		{
+			YAML::Node entity_node = cell.entities[cell.next_entity++];
+			cell.roots.push_back(deserializeEntity(entity_node, this->scene, this->resource_manager).handle());
+
+			if (std::chrono::high_resolution_clock::now() >= end_time)
+			{
+				//Finishing on the last entity still counts as loaded
+				if (cell.next_entity < entity_count)
+				{
+					return false;
+				}
+				break;
+			}
+		}
+
+		//The entities hold their own references now
+		cell.entities.reset();
+		cell.meshes.clear();
+		cell.materials.clear();
+		cell.textures.clear();
+		cell.state = CellState::Loaded;
+		this->loaded_cell_count++;
+		return std::chrono::high_resolution_clock::now() < end_time;
+	}
+}
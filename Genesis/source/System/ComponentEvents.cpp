@@ -0,0 +1,18 @@
+#include "Genesis/System/ComponentEvents.hpp"
+
+namespace Genesis
+{
+	void ComponentEvents::clearChanges(EntityRegistry& registry)
+	{
+		ComponentEventsContext* context = registry.try_ctx<ComponentEventsContext>();
+		if (context == nullptr)
+		{
+			return;
+		}
+
+		for (auto clear_function : context->clear_functions)
+		{
+			clear_function(registry);
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#include "Genesis/System/EntitySystemSet.hpp"
+
+namespace Genesis
+{
+	bool ComponentAccess::canRead(size_t type_hash) const
+	{
+		return this->exclusive
+			|| std::find(this->reads.begin(), this->reads.end(), type_hash) != this->reads.end()
+			|| std::find(this->writes.begin(), this->writes.end(), type_hash) != this->writes.end();
+	}
+
+	bool ComponentAccess::canWrite(size_t type_hash) const
+	{
+		return this->exclusive || std::find(this->writes.begin(), this->writes.end(), type_hash) != this->writes.end();
+	}
+
+	bool ComponentAccess::conflictsWith(const ComponentAccess& other) const
+	{
+		if (this->exclusive || other.exclusive || this->structural || other.structural)
+		{
+			return true;
+		}
+
+		for (size_t type_hash : this->writes)
+		{
+			if (other.canRead(type_hash))
+			{
+				return true;
+			}
+		}
+
+		for (size_t type_hash : other.writes)
+		{
+			if (this->canRead(type_hash))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void EntitySystemSet::setup_systems(Scene* scene)
+	{
+		for (auto system : this->systems)
+		{
+			system->setup(scene);
+		}
+	}
+
+	void EntitySystemSet::run_systems(Scene* scene, const TimeStep time_step)
+	{
+		if (this->job_system == nullptr || this->systems.size() < 2)
+		{
+			for (auto system : this->systems)
+			{
+				system->run(scene, time_step);
+			}
+			return;
+		}
+
+		if (!this->schedule)
+		{
+			this->buildSchedule();
+		}
+
+		this->run_scene = scene;
+		this->run_time_step = time_step;
+		this->schedule->execute(this->job_system);
+	}
+
+	string EntitySystemSet::dump()
+	{
+		return this->schedule ? this->schedule->dump() : string();
+	}
+
+	void EntitySystemSet::buildSchedule()
+	{
+		this->schedule = std::make_unique<TaskGraph>();
+
+		for (size_t i = 0; i < this->systems.size(); i++)
+		{
+			EntitySystem* system = this->systems[i];
+			TaskNodeId node = this->schedule->addNode("System " + std::to_string(i), [this, system]()
+			{
+				system->run(this->run_scene, this->run_time_step);
+			});
+
+			//Only the nearest conflicts need an edge, but extra edges are harmless and this only runs when the set changes
+			for (size_t j = 0; j < i; j++)
+			{
+				if (this->systems[j]->getAccess().conflictsWith(system->getAccess()))
+				{
+					this->schedule->addEdge((TaskNodeId)j, node);
+				}
+			}
+		}
+	}
+}
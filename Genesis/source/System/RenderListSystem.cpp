@@ -0,0 +1,22 @@
+#include "Genesis/System/RenderListSystem.hpp"
+
+#include "Genesis/Component/ModelComponent.hpp"
+#include "Genesis/Rendering/SceneRenderList.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
+
+namespace Genesis
+{
+	RenderListSystem::RenderListSystem(JobSystem* job_system)
+	{
+		this->job_system = job_system;
+
+		//The cache and hierarchy version live in the registry context, so they count as components here
+		this->reads<ParentNode, ChildNode, Transform, InterpolatedTransform, TransformHierarchyCache, HierarchyVersion, ModelComponent, DirectionalLight, PointLight, SpotLight>();
+	}
+
+	void RenderListSystem::run(Scene* scene, const TimeStep time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("RenderListSystem::run");
+		buildSceneRenderList(scene, scene->render_lists.getWriteList(), this->job_system);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "Genesis/System/SpatialIndexSystem.hpp"
+
+#include "Genesis/Component/ModelComponent.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
+
+namespace Genesis
+{
+	SpatialIndexSystem::SpatialIndexSystem()
+	{
+		this->reads<Transform, ModelComponent, TransformHierarchyCache, ComponentChanges<ModelComponent>, ComponentChanges<Transform>>();
+		this->writes<SpatialIndex>();
+	}
+
+	void SpatialIndexSystem::setup(Scene* scene)
+	{
+		EntityRegistry& registry = scene->registry;
+
+		//Anything from before the registry was observed is missed, so the next run rebuilds from scratch
+		if (ComponentEvents::getChanges<ModelComponent>(registry) == nullptr || ComponentEvents::getChanges<Transform>(registry) == nullptr)
+		{
+			ComponentEvents::observe<ModelComponent>(registry);
+			ComponentEvents::observe<Transform>(registry);
+			this->rebuild_pending = true;
+		}
+
+		if (!scene->scene_components.has<SpatialIndex>())
+		{
+			scene->scene_components.add<SpatialIndex>();
+			this->rebuild_pending = true;
+		}
+	}
+
+	void SpatialIndexSystem::run(Scene* scene, const TimeStep time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("SpatialIndexSystem::run");
+
+		EntityRegistry& registry = scene->registry;
+
+		//Only reads the registry's structure, anything missing means setup wasn't called after the registry was replaced
+		const bool is_setup = (ComponentEvents::getChanges<ModelComponent>(registry) != nullptr) && (ComponentEvents::getChanges<Transform>(registry) != nullptr) && scene->scene_components.has<SpatialIndex>();
+		GENESIS_ENGINE_ASSERT(is_setup, "SpatialIndexSystem::setup has to be called for the scene before it runs");
+		if (!is_setup)
+		{
+			return;
+		}
+
+		const bool rebuild = this->rebuild_pending;
+		this->rebuild_pending = false;
+
+		SpatialIndex& index = scene->scene_components.get<SpatialIndex>();
+
+		auto update = [&](EntityHandle entity)
+		{
+			AxisAlignedBoundingBox bounds;
+			if (registry.valid(entity) && SpatialIndexSystem::getWorldBounds(registry, entity, bounds))
+			{
+				index.insertOrUpdate(entity, bounds);
+			}
+			else
+			{
+				index.remove(entity);
+			}
+		};
+
+		if (rebuild)
+		{
+			index.clear();
+			for (EntityHandle entity : this->viewComponents<ModelComponent>(registry))
+			{
+				update(entity);
+			}
+		}
+		else
+		{
+			const ComponentChanges<ModelComponent>* model_changes = ComponentEvents::getChanges<ModelComponent>(registry);
+			const ComponentChanges<Transform>* transform_changes = ComponentEvents::getChanges<Transform>(registry);
+
+			for (EntityHandle entity : model_changes->destroyed)
+			{
+				index.remove(entity);
+			}
+
+			for (EntityHandle entity : transform_changes->destroyed)
+			{
+				index.remove(entity);
+			}
+
+			//update checks the entity is still valid, so something constructed and destroyed in the same frame ends up removed
+			for (EntityHandle entity : model_changes->constructed)
+			{
+				update(entity);
+			}
+
+			for (EntityHandle entity : model_changes->updated)
+			{
+				update(entity);
+			}
+
+			for (EntityHandle entity : TransformResolveSystem::getChangedEntities(registry))
+			{
+				if (this->tryReadComponent<ModelComponent>(registry, entity) != nullptr)
+				{
+					update(entity);
+				}
+			}
+		}
+	}
+
+	void SpatialIndexSystem::markChanged(EntityRegistry& registry, EntityHandle entity)
+	{
+		ComponentEvents::markUpdated<ModelComponent>(registry, entity);
+	}
+
+	bool SpatialIndexSystem::getWorldBounds(EntityRegistry& registry, EntityHandle entity, AxisAlignedBoundingBox& bounds)
+	{
+		ModelComponent* model = registry.try_get<ModelComponent>(entity);
+		Transform world_transform;
+		if (model == nullptr || !model->mesh || !TransformResolveSystem::getWorldTransform(registry, entity, world_transform))
+		{
+			return false;
+		}
+
+		//Rotating the box's extent by the absolute rotation matrix gives the tightest box around the rotated box
+		const BoundingBox& mesh_bounds = model->mesh->bounding_box;
+		const vector3F scale = (vector3F)world_transform.getScale();
+		const vector3F center = ((mesh_bounds.min + mesh_bounds.max) * 0.5f) * scale;
+		const vector3F extent = ((mesh_bounds.max - mesh_bounds.min) * 0.5f) * glm::abs(scale);
+
+		const matrix3F rotation = glm::toMat3((quaternionF)world_transform.getOrientation());
+		matrix3F absolute_rotation;
+		for (int i = 0; i < 3; i++)
+		{
+			absolute_rotation[i] = glm::abs(rotation[i]);
+		}
+
+		const vector3F world_center = (vector3F)world_transform.getPosition() + (rotation * center);
+		const vector3F world_extent = absolute_rotation * extent;
+		bounds = AxisAlignedBoundingBox(world_center - world_extent, world_center + world_extent);
+		return true;
+	}
+}
@@ -0,0 +1,456 @@
+#include "Genesis/System/TransformResolveSystem.hpp"
+
+//Minimum nodes per job when resolving a level, levels smaller than this aren't worth splitting
+#define resolve_grain_size 1024
+
+namespace Genesis
+{
+	void TransformResolveSystem::run(Scene* scene, const TimeStep time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("TransformResolveSystem::run");
+
+		EntityRegistry& registry = scene->registry;
+		TransformHierarchyCache& cache = this->getCache(registry);
+
+		//Moving an entity to a new parent bumps the version, the signals record everything else that changes the shape
+		const uint64_t version = HierarchyUtils::getVersion(registry);
+		const bool shape_changed = (cache.version != version) || !cache.added_entities.empty() || !cache.removed_entities.empty();
+		if (!cache.valid || (shape_changed && !this->updateCache(registry, cache)))
+		{
+			this->buildCache(registry, cache);
+			cache.changed_nodes.clear();
+			this->resolveLevels(registry, cache);
+		}
+		else
+		{
+			//Changed flags only last for the frame they were set in
+			for (uint32_t node : cache.changed_nodes)
+			{
+				//Destroyed since the last run
+				const EntityHandle entity = cache.entities[node];
+				if (entity == null_entity)
+				{
+					continue;
+				}
+
+				if (RootTransform* root_transform = this->tryWriteComponent<RootTransform>(registry, entity))
+				{
+					root_transform->clearChanged();
+				}
+
+				if (WorldTransform* world_transform = this->tryWriteComponent<WorldTransform>(registry, entity))
+				{
+					world_transform->clearChanged();
+				}
+			}
+
+			cache.changed_nodes.clear();
+			this->resolveDirty(registry, cache);
+
+			//Added after the dirty pass, so nothing in the new trees is resolved twice
+			if (!cache.new_roots.empty())
+			{
+				this->appendTrees(registry, cache, cache.new_roots);
+				this->resolveLevels(registry, cache);
+			}
+		}
+
+		cache.version = version;
+		cache.valid = true;
+		cache.added_entities.clear();
+		cache.removed_entities.clear();
+		cache.new_roots.clear();
+
+		this->checkWrite<TransformDirty>();
+		registry.clear<TransformDirty>();
+
+		cache.changed_entities.resize(cache.changed_nodes.size());
+		for (size_t i = 0; i < cache.changed_nodes.size(); i++)
+		{
+			cache.changed_entities[i] = cache.entities[cache.changed_nodes[i]];
+		}
+	}
+
+	void TransformResolveSystem::markDirty(EntityRegistry& registry, EntityHandle entity)
+	{
+		if (!registry.has<TransformDirty>(entity))
+		{
+			registry.emplace<TransformDirty>(entity);
+		}
+	}
+
+	const vector<EntityHandle>& TransformResolveSystem::getChangedEntities(EntityRegistry& registry)
+	{
+		static const vector<EntityHandle> empty_list;
+
+		TransformHierarchyCache* cache = registry.try_ctx<TransformHierarchyCache>();
+		return (cache != nullptr) ? cache->changed_entities : empty_list;
+	}
+
+	bool TransformResolveSystem::getWorldTransform(EntityRegistry& registry, EntityHandle entity, Transform& world_transform)
+	{
+		TransformHierarchyCache* cache = registry.try_ctx<TransformHierarchyCache>();
+		if (cache == nullptr || !cache->valid)
+		{
+			return false;
+		}
+
+		auto iterator = cache->entity_index.find(entity);
+		if (iterator == cache->entity_index.end())
+		{
+			return false;
+		}
+
+		world_transform = cache->world_transforms.get(iterator->second);
+		return true;
+	}
+
+	void TransformResolveSystem::onNodeAdded(EntityRegistry& registry, EntityHandle entity)
+	{
+		registry.ctx<TransformHierarchyCache>().added_entities.push_back(entity);
+	}
+
+	void TransformResolveSystem::onNodeRemoved(EntityRegistry& registry, EntityHandle entity)
+	{
+		registry.ctx<TransformHierarchyCache>().removed_entities.push_back(entity);
+	}
+
+	TransformHierarchyCache& TransformResolveSystem::getCache(EntityRegistry& registry)
+	{
+		this->checkWrite<TransformHierarchyCache>();
+		TransformHierarchyCache* cache = registry.try_ctx<TransformHierarchyCache>();
+		if (cache != nullptr)
+		{
+			return *cache;
+		}
+
+		TransformHierarchyCache& cache = registry.set<TransformHierarchyCache>();
+
+		//First time this registry has been seen, anything that changes which entities are in the cache is recorded for the next run
+		registry.on_construct<ChildNode>().connect<&TransformResolveSystem::onNodeAdded>();
+		registry.on_destroy<ChildNode>().connect<&TransformResolveSystem::onNodeRemoved>();
+		registry.on_construct<Transform>().connect<&TransformResolveSystem::onNodeAdded>();
+		registry.on_destroy<Transform>().connect<&TransformResolveSystem::onNodeRemoved>();
+
+		//A resolved component added to a cached entity has to be filled in, removing one doesn't need anything
+		registry.on_construct<RootTransform>().connect<&TransformResolveSystem::onNodeAdded>();
+		registry.on_construct<WorldTransform>().connect<&TransformResolveSystem::onNodeAdded>();
+
+		return cache;
+	}
+
+	void TransformResolveSystem::buildCache(EntityRegistry& registry, TransformHierarchyCache& cache)
+	{
+		GENESIS_PROFILE_FUNCTION("TransformResolveSystem::buildCache");
+
+		cache.entities.clear();
+		cache.parent_index.clear();
+		cache.child_begin.clear();
+		cache.child_end.clear();
+		cache.node_level.clear();
+		cache.root_index.clear();
+		cache.entity_index.clear();
+		cache.dirty_marks.clear();
+		cache.dead_count = 0;
+
+		//Roots without a transform are skipped along with everything under them
+		cache.new_roots.clear();
+		auto view = this->viewComponents<Transform>(registry, entt::exclude_t<ChildNode>());
+		for (EntityHandle entity : view)
+		{
+			cache.new_roots.push_back(entity);
+		}
+
+		this->appendTrees(registry, cache, cache.new_roots);
+	}
+
+	bool TransformResolveSystem::updateCache(EntityRegistry& registry, TransformHierarchyCache& cache)
+	{
+		GENESIS_PROFILE_FUNCTION("TransformResolveSystem::updateCache");
+
+		//Only a parent change bumps the version without a component being added or removed
+		if (cache.added_entities.empty() && cache.removed_entities.empty())
+		{
+			return false;
+		}
+
+		//Past this, looking at each change costs more than the rebuild
+		if ((cache.added_entities.size() + cache.removed_entities.size()) > cache.entities.size())
+		{
+			return false;
+		}
+
+		//Destroyed entities have to have taken everything under them along, anything left behind would need a new parent
+		for (EntityHandle entity : cache.removed_entities)
+		{
+			auto iterator = cache.entity_index.find(entity);
+			if (iterator == cache.entity_index.end() || registry.valid(entity))
+			{
+				continue;
+			}
+
+			const uint32_t node = iterator->second;
+			for (uint32_t child = cache.child_begin[node]; child < cache.child_end[node]; child++)
+			{
+				if (cache.entities[child] != null_entity && registry.valid(cache.entities[child]))
+				{
+					return false;
+				}
+			}
+
+			cache.entity_index.erase(iterator);
+			cache.entities[node] = null_entity;
+			cache.dead_count++;
+		}
+
+		//Mostly destroyed nodes, rebuilding packs the rest back together
+		if ((cache.dead_count * 2) > cache.entities.size())
+		{
+			return false;
+		}
+
+		//Whichever signal recorded them, the entities still alive are checked the same way
+		vector<EntityHandle>& entities = cache.added_entities;
+		entities.insert(entities.end(), cache.removed_entities.begin(), cache.removed_entities.end());
+		std::sort(entities.begin(), entities.end());
+		entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+		for (EntityHandle entity : entities)
+		{
+			if (!registry.valid(entity))
+			{
+				continue;
+			}
+
+			const ChildNode* child_node = registry.try_get<ChildNode>(entity);
+			const EntityHandle parent = (child_node != nullptr) ? child_node->parent : null_entity;
+
+			auto iterator = cache.entity_index.find(entity);
+			if (iterator != cache.entity_index.end())
+			{
+				//Still under the same parent, so it only gained or lost a Transform or a resolved component
+				const uint32_t parent_node = cache.parent_index[iterator->second];
+				const EntityHandle cached_parent = (parent_node != TransformHierarchyCache::no_parent) ? cache.entities[parent_node] : null_entity;
+				if (parent != cached_parent || (parent == null_entity && !registry.has<Transform>(entity)))
+				{
+					return false;
+				}
+
+				TransformResolveSystem::markDirty(registry, entity);
+			}
+			else if (parent != null_entity)
+			{
+				//Fine under a parent that isn't cached either, the parent is checked itself if it's new
+				if (cache.entity_index.find(parent) != cache.entity_index.end())
+				{
+					return false;
+				}
+			}
+			else if (registry.has<Transform>(entity))
+			{
+				//Everything under a new root is appended with it
+				cache.new_roots.push_back(entity);
+			}
+		}
+
+		return true;
+	}
+
+	void TransformResolveSystem::appendTrees(EntityRegistry& registry, TransformHierarchyCache& cache, const vector<EntityHandle>& roots)
+	{
+		GENESIS_PROFILE_FUNCTION("TransformResolveSystem::appendTrees");
+
+		const size_t first_node = cache.entities.size();
+		for (EntityHandle root : roots)
+		{
+			cache.root_index.push_back((uint32_t)cache.entities.size());
+			cache.entities.push_back(root);
+			cache.parent_index.push_back(TransformHierarchyCache::no_parent);
+			cache.node_level.push_back(0);
+		}
+
+		//Breadth first, so each level's children are appended in parent order
+		cache.level_offsets.clear();
+		cache.level_offsets.push_back(first_node);
+		size_t level_begin = first_node;
+		while (level_begin < cache.entities.size())
+		{
+			const size_t level_end = cache.entities.size();
+			const uint32_t child_level = (uint32_t)cache.level_offsets.size();
+			for (size_t i = level_begin; i < level_end; i++)
+			{
+				cache.child_begin.push_back((uint32_t)cache.entities.size());
+				for (EntityHandle child : EntityHiearchy(&registry, cache.entities[i]))
+				{
+					cache.entities.push_back(child);
+					cache.parent_index.push_back((uint32_t)i);
+					cache.node_level.push_back(child_level);
+					cache.root_index.push_back(cache.root_index[i]);
+				}
+				cache.child_end.push_back((uint32_t)cache.entities.size());
+			}
+
+			cache.level_offsets.push_back(level_end);
+			level_begin = level_end;
+		}
+
+		const size_t count = cache.entities.size();
+		cache.local_batch.resize(count);
+		cache.root_transforms.resize(count);
+		cache.world_transforms.resize(count);
+		cache.dirty_marks.resize(count, 0);
+		cache.entity_index.reserve(count);
+
+		if (cache.level_dirty_nodes.size() < cache.level_offsets.size())
+		{
+			cache.level_dirty_nodes.resize(cache.level_offsets.size());
+		}
+
+		for (size_t i = first_node; i < count; i++)
+		{
+			cache.entity_index[cache.entities[i]] = (uint32_t)i;
+		}
+	}
+
+	void TransformResolveSystem::resolveLevels(EntityRegistry& registry, TransformHierarchyCache& cache)
+	{
+		//Levels have to be done in order since each one reads the level above, but everything inside a level is independent
+		for (size_t level = 0; (level + 1) < cache.level_offsets.size(); level++)
+		{
+			const size_t begin = cache.level_offsets[level];
+			const size_t end = cache.level_offsets[level + 1];
+
+			if (this->job_system != nullptr)
+			{
+				this->job_system->parallel_for_chunks(begin, end, resolve_grain_size, [&](uint32_t thread_id, size_t chunk_begin, size_t chunk_end)
+				{
+					this->resolveRange(registry, cache, chunk_begin, chunk_end);
+				});
+			}
+			else
+			{
+				this->resolveRange(registry, cache, begin, end);
+			}
+		}
+
+		for (size_t i = cache.level_offsets.front(); i < cache.level_offsets.back(); i++)
+		{
+			cache.changed_nodes.push_back((uint32_t)i);
+		}
+	}
+
+	void TransformResolveSystem::resolveDirty(EntityRegistry& registry, TransformHierarchyCache& cache)
+	{
+		auto view = this->viewComponents<TransformDirty>(registry);
+		if (view.empty())
+		{
+			return;
+		}
+
+		for (EntityHandle entity : view)
+		{
+			auto iterator = cache.entity_index.find(entity);
+			if (iterator != cache.entity_index.end() && cache.dirty_marks[iterator->second] == 0)
+			{
+				cache.dirty_marks[iterator->second] = 1;
+				cache.level_dirty_nodes[cache.node_level[iterator->second]].push_back(iterator->second);
+			}
+		}
+
+		for (size_t level = 0; level < cache.level_dirty_nodes.size(); level++)
+		{
+			vector<uint32_t>& dirty_nodes = cache.level_dirty_nodes[level];
+			if (dirty_nodes.empty())
+			{
+				continue;
+			}
+
+			if (this->job_system != nullptr)
+			{
+				this->job_system->parallel_for_chunks(0, dirty_nodes.size(), resolve_grain_size, [&](uint32_t thread_id, size_t chunk_begin, size_t chunk_end)
+				{
+					for (size_t i = chunk_begin; i < chunk_end; i++)
+					{
+						this->resolveRange(registry, cache, dirty_nodes[i], dirty_nodes[i] + 1);
+					}
+				});
+			}
+			else
+			{
+				for (uint32_t node : dirty_nodes)
+				{
+					this->resolveRange(registry, cache, node, node + 1);
+				}
+			}
+
+			//Everything under a resolved node has to be resolved too, destroyed children stay in their parent's range until the next rebuild
+			for (uint32_t node : dirty_nodes)
+			{
+				for (uint32_t child = cache.child_begin[node]; child < cache.child_end[node]; child++)
+				{
+					if (cache.dirty_marks[child] == 0 && cache.entities[child] != null_entity)
+					{
+						cache.dirty_marks[child] = 1;
+						cache.level_dirty_nodes[level + 1].push_back(child);
+					}
+				}
+			}
+
+			cache.changed_nodes.insert(cache.changed_nodes.end(), dirty_nodes.begin(), dirty_nodes.end());
+			dirty_nodes.clear();
+		}
+
+		for (uint32_t node : cache.changed_nodes)
+		{
+			cache.dirty_marks[node] = 0;
+		}
+	}
+
+	void TransformResolveSystem::resolveRange(EntityRegistry& registry, TransformHierarchyCache& cache, size_t begin, size_t end)
+	{
+		//Nodes without a local transform take their parent's transform as is, which is what composing with identity gives
+		for (size_t i = begin; i < end; i++)
+		{
+			if (const Transform* local_transform = this->tryReadComponent<Transform>(registry, cache.entities[i]))
+			{
+				cache.local_batch.set(i, *local_transform);
+			}
+			else
+			{
+				cache.local_batch.setIdentity(i);
+			}
+		}
+
+		//A range never spans levels, so it is either all roots or all children
+		if (cache.parent_index[begin] == TransformHierarchyCache::no_parent)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				//Root transform only gets the scale of the root object
+				cache.root_transforms.setIdentity(i);
+				cache.root_transforms.scale_x[i] = cache.local_batch.scale_x[i];
+				cache.root_transforms.scale_y[i] = cache.local_batch.scale_y[i];
+				cache.root_transforms.scale_z[i] = cache.local_batch.scale_z[i];
+				cache.world_transforms.set(i, cache.local_batch.get(i));
+			}
+		}
+		else
+		{
+			TransformBatch::composeIndexed(cache.root_transforms, cache.parent_index.data(), cache.local_batch, cache.root_transforms, begin, end);
+			TransformBatch::composeIndexed(cache.world_transforms, cache.parent_index.data(), cache.local_batch, cache.world_transforms, begin, end);
+		}
+
+		for (size_t i = begin; i < end; i++)
+		{
+			if (RootTransform* root_transform = this->tryWriteComponent<RootTransform>(registry, cache.entities[i]))
+			{
+				root_transform->setTransform(cache.root_transforms.get(i));
+			}
+
+			if (WorldTransform* world_transform = this->tryWriteComponent<WorldTransform>(registry, cache.entities[i]))
+			{
+				world_transform->setTransform(cache.world_transforms.get(i));
+			}
+		}
+	}
+}
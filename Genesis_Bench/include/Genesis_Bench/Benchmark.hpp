@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+
+namespace Genesis
+{
+	struct BenchmarkResult
+	{
+		string name;
+		string shape;
+		size_t entity_count = 0;
+		size_t iterations = 0;
+
+		double min_ms = 0.0;
+		double median_ms = 0.0;
+		double mean_ms = 0.0;
+	};
+
+	class BenchmarkSuite
+	{
+	public:
+		//Only benchmarks with this in their name are run, empty runs everything
+		string filter;
+
+		bool shouldRun(const string& name) const { return this->filter.empty() || (name.find(this->filter) != string::npos); };
+
+		//Times body over the given number of iterations, setup runs before each one and isn't counted
+		template<typename Setup, typename Body>
+		void run(const string& name, const string& shape, size_t entity_count, size_t iterations, Setup setup, Body body)
+		{
+			if (!this->shouldRun(name))
+			{
+				return;
+			}
+
+			using clock = std::chrono::high_resolution_clock;
+
+			vector<double> times(iterations);
+			for (size_t i = 0; i < iterations; i++)
+			{
+				setup();
+				const clock::time_point start = clock::now();
+				body();
+				times[i] = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			}
+
+			this->addResult(name, shape, entity_count, times);
+		};
+
+		const vector<BenchmarkResult>& getResults() const { return this->results; };
+
+		void writeJson(std::ostream& out) const;
+
+		//Prints every result next to its baseline and returns how many got slower by more than threshold, eg 0.1 for 10%
+		//Results missing from either side are listed but don't count as regressions
+		size_t compareBaseline(const string& baseline_path, double threshold) const;
+
+	protected:
+		void addResult(const string& name, const string& shape, size_t entity_count, vector<double>& times);
+
+		vector<BenchmarkResult> results;
+	};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Genesis/LegacyBackend/LegacyBackend.hpp"
+
+namespace Genesis
+{
+	//Backend that doesn't draw anything, so resources and renderers can be used without a window or GPU
+	//Handles are all null, only the draw and bind counts are kept
+	class NullBackend : public LegacyBackend
+	{
+	public:
+		virtual ~NullBackend() {};
+
+		virtual vector2U getScreenSize() override { return vector2U(1920, 1080); };
+
+		virtual void startFrame() override { this->frame_stats = {}; };
+		virtual void endFrame() override { this->last_frame_stats = this->frame_stats; };
+
+		virtual VertexBuffer createVertexBuffer(void* data, uint64_t data_size, const VertexInputDescriptionCreateInfo& vertex_description) override { return nullptr; };
+		virtual void destoryVertexBuffer(VertexBuffer buffer) override {};
+
+		virtual IndexBuffer createIndexBuffer(void* data, uint64_t data_size, IndexType type) override { return nullptr; };
+		virtual void destoryIndexBuffer(IndexBuffer buffer) override {};
+
+		virtual Texture2D createTexture(const TextureCreateInfo& create_info, void* data) override { return nullptr; };
+		virtual void destoryTexture(Texture2D texture) override {};
+
+		virtual ShaderProgram createShaderProgram(const char* vert_data, uint32_t vert_size, const char* frag_data, uint32_t frag_size) override { return nullptr; };
+		virtual ShaderProgram createComputeShader(const char* data, uint32_t size) override { return nullptr; };
+		virtual void destoryShaderProgram(ShaderProgram program) override {};
+
+		virtual Framebuffer createFramebuffer(const FramebufferCreateInfo& create_info) override { return nullptr; };
+		virtual void destoryFramebuffer(Framebuffer framebuffer) override {};
+		virtual Texture2D getFramebufferColorAttachment(Framebuffer framebuffer, uint32_t index) override { return nullptr; };
+		virtual Texture2D getFramebufferDepthAttachment(Framebuffer framebuffer) override { return nullptr; };
+
+		virtual void bindFramebuffer(Framebuffer framebuffer) override {};
+		virtual void clearFramebuffer(bool color, bool depth, vector4F* clear_color = nullptr, float* clear_depth = nullptr) override {};
+
+		virtual void setPipelineState(const PipelineSettings& pipeline_state) override {};
+
+		virtual void bindShaderProgram(ShaderProgram program) override {};
+		virtual void setUniform1i(const string& name, const int32_t& value) override {};
+
+		virtual void setUniform1u(const string& name, const uint32_t& value) override {};
+		virtual void setUniform2u(const string& name, const vector2U& value) override {};
+		virtual void setUniform3u(const string& name, const vector3U& value) override {};
+		virtual void setUniform4u(const string& name, const vector4U& value) override {};
+
+		virtual void setUniform1f(const string& name, const float& value) override {};
+		virtual void setUniform2f(const string& name, const vector2F& value) override {};
+		virtual void setUniform3f(const string& name, const vector3F& value) override {};
+		virtual void setUniform4f(const string& name, const vector4F& value) override {};
+
+		virtual void setUniformMat3f(const string& name, const matrix3F& value) override {};
+		virtual void setUniformMat4f(const string& name, const matrix4F& value) override {};
+
+		virtual void setUniformTexture(const string& name, const uint32_t texture_slot, Texture2D value) override { this->frame_stats.texture_binds++; };
+		virtual void setUniformTextureImage(const string& name, const uint32_t texture_slot, Texture2D value) override {};
+
+		virtual void setScissor(vector2I offset, vector2U extent) override {};
+		virtual void clearScissor() override {};
+
+		virtual void bindVertexBuffer(VertexBuffer buffer) override { this->frame_stats.buffer_binds++; };
+		virtual void bindIndexBuffer(IndexBuffer buffer) override { this->frame_stats.buffer_binds++; };
+		virtual void drawIndex(uint32_t index_count, uint32_t index_offset = 0) override
+		{
+			this->frame_stats.draw_calls++;
+			this->frame_stats.triangles_count += index_count / 3;
+		};
+
+		virtual void uploadInstanceBuffer(const void* data, uint64_t data_size, const VertexInputDescriptionCreateInfo& instance_description) override {};
+		virtual void drawIndexInstanced(uint32_t index_count, uint32_t instance_count, uint32_t first_instance, uint32_t index_offset = 0) override
+		{
+			this->frame_stats.draw_calls++;
+			this->frame_stats.triangles_count += (uint64_t)(index_count / 3) * instance_count;
+		};
+
+		virtual void uploadStorageBuffer(uint32_t binding, const void* data, uint64_t data_size) override {};
+
+		virtual void draw(VertexBuffer vertex_buffer, IndexBuffer index_buffer, uint32_t triangle_count) override
+		{
+			this->frame_stats.draw_calls++;
+			this->frame_stats.triangles_count += triangle_count;
+		};
+
+		virtual void dispatchCompute(uint32_t groups_x = 1, uint32_t groups_y = 1, uint32_t groups_z = 1) override {};
+
+		virtual void addModelStats(uint64_t models_drawn, uint64_t models_culled) override
+		{
+			this->frame_stats.models_drawn += models_drawn;
+			this->frame_stats.models_culled += models_culled;
+		};
+
+		virtual FrameStats getLastFrameStats() override { return this->last_frame_stats; };
+
+	protected:
+		FrameStats frame_stats = {};
+		FrameStats last_frame_stats = {};
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Component/ModelComponent.hpp"
+
+namespace Genesis
+{
+	enum class SceneShape
+	{
+		//Every entity is a root
+		Flat,
+		//Long parent to child chains
+		Deep,
+		//Few roots with a lot of children each
+		Wide,
+	};
+
+	const char* getSceneShapeName(SceneShape shape);
+
+	//Builds the same scene for the same arguments every time, every entity gets a Transform and the given model
+	Scene* generateScene(SceneShape shape, size_t entity_count, const ModelComponent& model);
+
+	//Adds entity_count entities laid out the same way to an existing scene, the new roots are appended to roots if given
+	void addSceneEntities(Scene* scene, SceneShape shape, size_t entity_count, const ModelComponent& model, uint64_t seed, vector<EntityHandle>* roots = nullptr);
+}
@@ -0,0 +1,95 @@
+#include "Genesis_Bench/Benchmark.hpp"
+
+#include "Genesis/Core/Yaml.hpp"
+
+namespace Genesis
+{
+	static string getResultKey(const string& name, const string& shape, size_t entity_count)
+	{
+		return name + "/" + shape + "/" + std::to_string(entity_count);
+	}
+
+	void BenchmarkSuite::addResult(const string& name, const string& shape, size_t entity_count, vector<double>& times)
+	{
+		BenchmarkResult result;
+		result.name = name;
+		result.shape = shape;
+		result.entity_count = entity_count;
+		result.iterations = times.size();
+
+		if (!times.empty())
+		{
+			std::sort(times.begin(), times.end());
+
+			double total = 0.0;
+			for (double time : times)
+			{
+				total += time;
+			}
+
+			result.min_ms = times.front();
+			result.median_ms = times[times.size() / 2];
+			result.mean_ms = total / (double)times.size();
+		}
+
+		printf("%-32s %-6s %10zu  median %12.4f ms  min %12.4f ms\n", name.c_str(), shape.c_str(), entity_count, result.median_ms, result.min_ms);
+		fflush(stdout);
+
+		this->results.push_back(result);
+	}
+
+	void BenchmarkSuite::writeJson(std::ostream& out) const
+	{
+		//Names are all plain identifiers, so nothing needs escaping
+		out << "{\n\t\"benchmarks\": [\n";
+		for (size_t i = 0; i < this->results.size(); i++)
+		{
+			const BenchmarkResult& result = this->results[i];
+			out << "\t\t{ \"name\": \"" << result.name << "\", \"shape\": \"" << result.shape << "\", \"entities\": " << result.entity_count
+				<< ", \"iterations\": " << result.iterations << ", \"min_ms\": " << result.min_ms << ", \"median_ms\": " << result.median_ms
+				<< ", \"mean_ms\": " << result.mean_ms << " }" << ((i + 1 < this->results.size()) ? ",\n" : "\n");
+		}
+		out << "\t]\n}\n";
+	}
+
+	size_t BenchmarkSuite::compareBaseline(const string& baseline_path, double threshold) const
+	{
+		//JSON is a subset of YAML, so the baseline can be read with the same parser as everything else
+		YAML::Node baseline_node = YAML::LoadFile(baseline_path);
+
+		flat_hash_map<string, double> baseline_medians;
+		for (auto benchmark_node : baseline_node["benchmarks"])
+		{
+			const string key = getResultKey(benchmark_node["name"].as<string>(), benchmark_node["shape"].as<string>(), benchmark_node["entities"].as<size_t>());
+			baseline_medians[key] = benchmark_node["median_ms"].as<double>();
+		}
+
+		size_t regressions = 0;
+		printf("\n%-32s %-6s %10s %14s %14s %9s\n", "benchmark", "shape", "entities", "baseline ms", "current ms", "change");
+		for (const BenchmarkResult& result : this->results)
+		{
+			auto it = baseline_medians.find(getResultKey(result.name, result.shape, result.entity_count));
+			if (it == baseline_medians.end())
+			{
+				printf("%-32s %-6s %10zu %14s %14.4f %9s\n", result.name.c_str(), result.shape.c_str(), result.entity_count, "-", result.median_ms, "new");
+				continue;
+			}
+
+			const double baseline_ms = it->second;
+			const double change = (baseline_ms > 0.0) ? ((result.median_ms - baseline_ms) / baseline_ms) : 0.0;
+			const bool regressed = change > threshold;
+			regressions += regressed ? 1 : 0;
+
+			printf("%-32s %-6s %10zu %14.4f %14.4f %+8.1f%%%s\n", result.name.c_str(), result.shape.c_str(), result.entity_count, baseline_ms, result.median_ms, change * 100.0, regressed ? "  REGRESSION" : "");
+			baseline_medians.erase(it);
+		}
+
+		for (auto& pair : baseline_medians)
+		{
+			printf("%-52s missing from this run\n", pair.first.c_str());
+		}
+
+		printf("\n%zu regression(s) over %.1f%%\n", regressions, threshold * 100.0);
+		return regressions;
+	}
+}
@@ -0,0 +1,295 @@
+#include "Genesis_Bench/Benchmark.hpp"
+#include "Genesis_Bench/NullBackend.hpp"
+#include "Genesis_Bench/SceneGenerator.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+
+#include "Genesis/Job/JobSystem.hpp"
+#include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Scene/Hierarchy.hpp"
+#include "Genesis/Scene/SceneSerializer.hpp"
+#include "Genesis/Resource/ResourceManager.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
+#include "Genesis/Rendering/SceneRenderList.hpp"
+
+//YAML output grows fast, past this the save and load benchmarks take minutes and gigabytes
+#define serializer_max_entities 100000
+
+//Streaming benchmarks swap out this fraction of the scene each iteration, about one cell of a large world
+#define streamed_cell_divisor 100
+
+//Iterations are scaled down for bigger scenes, but never below this so the median still means something
+#define min_iterations 3
+
+using namespace Genesis;
+
+struct BenchSettings
+{
+	string output_path;
+	string baseline_path;
+	string filter;
+	double threshold = 0.1;
+	size_t max_entities = 1000000;
+	size_t iterations = 10;
+	uint32_t thread_count = 0;
+};
+
+static void printUsage()
+{
+	printf("Genesis_Bench [options]\n");
+	printf("  --output <file>        Writes the results as JSON\n");
+	printf("  --baseline <file>      Compares against an earlier --output, exits with 1 on any regression\n");
+	printf("  --threshold <ratio>    Slowdown counted as a regression, default 0.1\n");
+	printf("  --filter <text>        Only runs benchmarks with text in their name\n");
+	printf("  --max-entities <n>     Largest scene size, default 1000000\n");
+	printf("  --iterations <n>       Iterations for the smallest scenes, default 10\n");
+	printf("  --threads <n>          Job threads, default one per hardware thread\n");
+}
+
+static bool parseArguments(int argc, char** argv, BenchSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const string argument = argv[i];
+		const bool has_value = (i + 1) < argc;
+
+		if (argument == "--output" && has_value)
+		{
+			settings.output_path = argv[++i];
+		}
+		else if (argument == "--baseline" && has_value)
+		{
+			settings.baseline_path = argv[++i];
+		}
+		else if (argument == "--threshold" && has_value)
+		{
+			settings.threshold = std::stod(argv[++i]);
+		}
+		else if (argument == "--filter" && has_value)
+		{
+			settings.filter = argv[++i];
+		}
+		else if (argument == "--max-entities" && has_value)
+		{
+			settings.max_entities = std::stoull(argv[++i]);
+		}
+		else if (argument == "--iterations" && has_value)
+		{
+			settings.iterations = std::stoull(argv[++i]);
+		}
+		else if (argument == "--threads" && has_value)
+		{
+			settings.thread_count = (uint32_t)std::stoul(argv[++i]);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//A one triangle mesh and a plain material written to disk, so the serializer benchmarks resolve real resource names
+static ModelComponent createBenchModel(ResourceManager* resource_manager, const string& directory)
+{
+	const string mesh_path = directory + "/bench_triangle.obj";
+	const string material_path = directory + "/bench.mat";
+
+	{
+		std::ofstream mesh_out(mesh_path);
+		mesh_out << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\nf 1/1/1 2/2/1 3/3/1\n";
+	}
+
+	{
+		std::ofstream material_out(material_path);
+		material_out << "albedo_factor: [1, 1, 1, 1]\n";
+	}
+
+	ModelComponent model;
+	model.mesh = resource_manager->mesh_pool.getResource(mesh_path);
+	model.material = resource_manager->material_pool.getResource(material_path);
+	return model;
+}
+
+static void runSceneBenchmarks(BenchmarkSuite& suite, const BenchSettings& settings, JobSystem* job_system, ResourceManager* resource_manager, const ModelComponent& model, const string& directory, SceneShape shape, size_t entity_count)
+{
+	const string shape_name = getSceneShapeName(shape);
+	const size_t iterations = std::min<size_t>(settings.iterations, std::max<size_t>(min_iterations, (settings.iterations * 1000) / entity_count));
+
+	std::unique_ptr<Scene> scene(generateScene(shape, entity_count, model));
+	TransformResolveSystem transform_system(job_system);
+
+	//Rebuilds the flattened hierarchy every run, the cost after any structural change
+	suite.run("transform_resolve_full", shape_name, entity_count, iterations, [&]()
+	{
+		HierarchyUtils::markChanged(scene->registry);
+	}, [&]()
+	{
+		transform_system.run(scene.get(), 0.0);
+	});
+
+	//Every root dirty but the hierarchy unchanged, the cost when everything moves
+	vector<EntityHandle> roots;
+	scene->registry.each([&](EntityHandle entity)
+	{
+		if (entity != scene->scene_components.handle() && !scene->registry.has<ChildNode>(entity))
+		{
+			roots.push_back(entity);
+		}
+	});
+
+	suite.run("transform_resolve_dirty", shape_name, entity_count, iterations, [&]()
+	{
+		for (EntityHandle root : roots)
+		{
+			TransformResolveSystem::markDirty(scene->registry, root);
+		}
+	}, [&]()
+	{
+		transform_system.run(scene.get(), 0.0);
+	});
+
+	//A cell's worth of trees is destroyed and another one created before each run, the cost while a world streams in around the camera
+	const size_t cell_entity_count = std::max<size_t>(entity_count / streamed_cell_divisor, 1);
+	vector<EntityHandle> streamed_roots;
+	uint64_t streamed_cell = 0;
+	auto destroy_streamed = [&]()
+	{
+		for (EntityHandle root : streamed_roots)
+		{
+			scene->destoryEntity(Entity(scene.get(), root));
+		}
+		streamed_roots.clear();
+	};
+
+	suite.run("transform_resolve_streaming", shape_name, entity_count, iterations, [&]()
+	{
+		destroy_streamed();
+		addSceneEntities(scene.get(), shape, cell_entity_count, model, entity_count + (++streamed_cell), &streamed_roots);
+	}, [&]()
+	{
+		transform_system.run(scene.get(), 0.0);
+	});
+
+	//Back to the generated scene for everything after this
+	destroy_streamed();
+	transform_system.run(scene.get(), 0.0);
+
+	SceneRenderList render_list;
+	suite.run("build_scene_render_list", shape_name, entity_count, iterations, []() {}, [&]()
+	{
+		buildSceneRenderList(scene.get(), render_list, job_system);
+	});
+
+	//Pairs of roots are linked then unlinked again, so the scene ends up as it started
+	suite.run("hierarchy_edit", shape_name, entity_count, iterations, []() {}, [&]()
+	{
+		for (size_t i = 0; i + 1 < roots.size(); i += 2)
+		{
+			HierarchyUtils::addChild(scene->registry, roots[i], roots[i + 1]);
+		}
+
+		for (size_t i = 0; i + 1 < roots.size(); i += 2)
+		{
+			HierarchyUtils::removeChild(scene->registry, roots[i], roots[i + 1]);
+		}
+	});
+
+	if (entity_count <= serializer_max_entities)
+	{
+		const string scene_path = directory + "/bench_" + shape_name + "_" + std::to_string(entity_count) + ".scene";
+
+		suite.run("scene_serializer_save", shape_name, entity_count, iterations, []() {}, [&]()
+		{
+			SceneSerializer().serialize(scene.get(), scene_path.c_str());
+		});
+
+		suite.run("scene_serializer_load", shape_name, entity_count, iterations, []() {}, [&]()
+		{
+			delete SceneSerializer().deserialize(scene_path.c_str(), resource_manager);
+		});
+
+		std::filesystem::remove(scene_path);
+	}
+
+	//Needs a fresh scene every iteration, the destroy itself is all that's timed
+	std::unique_ptr<Scene> destroy_scene;
+	vector<EntityHandle> destroy_roots;
+	suite.run("destroy_entity", shape_name, entity_count, iterations, [&]()
+	{
+		destroy_scene.reset(generateScene(shape, entity_count, model));
+		destroy_roots.clear();
+		destroy_scene->registry.each([&](EntityHandle entity)
+		{
+			if (entity != destroy_scene->scene_components.handle() && !destroy_scene->registry.has<ChildNode>(entity))
+			{
+				destroy_roots.push_back(entity);
+			}
+		});
+	}, [&]()
+	{
+		for (EntityHandle root : destroy_roots)
+		{
+			destroy_scene->destoryEntity(Entity(destroy_scene.get(), root));
+		}
+	});
+}
+
+int main(int argc, char** argv)
+{
+	Genesis::Logging::inti_engine_logging();
+	Genesis::Logging::inti_client_logging("Genesis_Bench");
+
+	BenchSettings settings;
+	if (!parseArguments(argc, argv, settings))
+	{
+		printUsage();
+		return 2;
+	}
+
+	const string directory = (std::filesystem::temp_directory_path() / "genesis_bench").string();
+	std::filesystem::create_directories(directory);
+
+	JobSystem* job_system = new JobSystem(settings.thread_count);
+	NullBackend* backend = new NullBackend();
+	ResourceManager* resource_manager = new ResourceManager(backend);
+
+	BenchmarkSuite suite;
+	suite.filter = settings.filter;
+
+	//The model has to be gone before the backend its mesh was made with
+	{
+		const ModelComponent model = createBenchModel(resource_manager, directory);
+
+		const SceneShape shapes[] = { SceneShape::Flat, SceneShape::Deep, SceneShape::Wide };
+		for (size_t entity_count = 1000; entity_count <= settings.max_entities; entity_count *= 10)
+		{
+			for (SceneShape shape : shapes)
+			{
+				runSceneBenchmarks(suite, settings, job_system, resource_manager, model, directory, shape, entity_count);
+			}
+		}
+	}
+
+	if (!settings.output_path.empty())
+	{
+		std::ofstream output(settings.output_path);
+		suite.writeJson(output);
+		printf("Results written to %s\n", settings.output_path.c_str());
+	}
+
+	size_t regressions = 0;
+	if (!settings.baseline_path.empty())
+	{
+		regressions = suite.compareBaseline(settings.baseline_path, settings.threshold);
+	}
+
+	delete resource_manager;
+	delete backend;
+	delete job_system;
+
+	return (regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+#include "Genesis_Bench/SceneGenerator.hpp"
+
+#include <random>
+
+#include "Genesis/Scene/Entity.hpp"
+#include "Genesis/Scene/Hierarchy.hpp"
+#include "Genesis/Component/TransformComponent.hpp"
+
+//Length of each chain in deep scenes
+#define deep_chain_length 1024
+
+//Children under each root in wide scenes
+#define wide_child_count 1023
+
+//Roots are spread over a cube this size
+#define scene_extent 4096.0
+
+namespace Genesis
+{
+	const char* getSceneShapeName(SceneShape shape)
+	{
+		switch (shape)
+		{
+		case SceneShape::Flat:
+			return "flat";
+		case SceneShape::Deep:
+			return "deep";
+		case SceneShape::Wide:
+			return "wide";
+		}
+		return "unknown";
+	}
+
+	Scene* generateScene(SceneShape shape, size_t entity_count, const ModelComponent& model)
+	{
+		GENESIS_PROFILE_FUNCTION("generateScene");
+
+		Scene* scene = new Scene();
+		scene->registry.reserve<Transform>(entity_count);
+		scene->registry.reserve<ModelComponent>(entity_count);
+		addSceneEntities(scene, shape, entity_count, model, entity_count);
+		return scene;
+	}
+
+	void addSceneEntities(Scene* scene, SceneShape shape, size_t entity_count, const ModelComponent& model, uint64_t seed, vector<EntityHandle>* roots)
+	{
+		EntityRegistry& registry = scene->registry;
+
+		std::mt19937_64 random(seed);
+		std::uniform_real_distribution<double> root_position(-scene_extent * 0.5, scene_extent * 0.5);
+		std::uniform_real_distribution<double> local_position(-2.0, 2.0);
+		std::uniform_real_distribution<double> angle(0.0, 2.0 * PI_D);
+
+		EntityHandle parent = null_entity;
+		for (size_t i = 0; i < entity_count; i++)
+		{
+			const bool is_root = (shape == SceneShape::Flat)
+				|| (shape == SceneShape::Deep && (i % deep_chain_length) == 0)
+				|| (shape == SceneShape::Wide && (i % (wide_child_count + 1)) == 0);
+
+			EntityHandle entity = scene->createEntity("Bench Entity").handle();
+			const vector3D position = is_root ? vector3D(root_position(random), root_position(random), root_position(random)) : vector3D(local_position(random), local_position(random), local_position(random));
+			registry.emplace<Transform>(entity, position, glm::angleAxis(angle(random), vector3D(0.0, 1.0, 0.0)));
+			registry.emplace<ModelComponent>(entity, model);
+
+			if (is_root)
+			{
+				if (roots != nullptr)
+				{
+					roots->push_back(entity);
+				}
+
+				parent = entity;
+				continue;
+			}
+
+			HierarchyUtils::addChild(registry, parent, entity);
+
+			//Each entity in a chain is the parent of the next one
+			if (shape == SceneShape::Deep)
+			{
+				parent = entity;
+			}
+		}
+	}
+}
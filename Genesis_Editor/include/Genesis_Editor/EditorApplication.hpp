@@ -20,8 +20,16 @@
 
 #include "Genesis/Scene/Ecs.hpp"
 #include "Genesis/Scene/Scene.hpp"
+#include "Genesis/Scene/SceneSnapshot.hpp"
+#include "Genesis/Scene/WorldPartition.hpp"
 #include "Genesis/Rendering/SceneRenderList.hpp"
 
+#include "Genesis/Job/TaskGraph.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
+#include "Genesis/System/SpatialIndexSystem.hpp"
+#include "Genesis/System/RenderListSystem.hpp"
+#include "Genesis/System/EntitySystemSet.hpp"
+
 namespace Genesis
 {
 	class EditorApplication : public Application
@@ -31,10 +39,36 @@ namespace Genesis
 		virtual ~EditorApplication();
 
 		virtual void update(TimeStep time_step) override;
+		virtual void fixedUpdate(TimeStep fixed_time_step) override;
+		virtual void simulate(TimeStep time_step) override;
 		virtual void render(TimeStep interpolation_value) override;
+		virtual void finishFrame() override;
 	protected:
+		void draw_ui();
+		void draw_scene_view();
+
 		Scene* editor_scene = nullptr;
 
+		//The editor scene as it was when play was pressed, written back over it on stop
+		SceneSnapshot play_snapshot;
+		bool is_playing = false;
+
+		//Set while a world file is open, streams cells in around the scene camera
+		std::unique_ptr<WorldPartition> world_partition;
+
+		//Frame stages, update_graph runs in update and simulate_graph in simulate
+		TaskGraph update_graph;
+		TaskGraph simulate_graph;
+		TimeStep frame_time_step = 0.0;
+		TimeStep simulate_time_step = 0.0;
+		bool dump_frame_graph = false;
+
+		//Scheduled by simulate_systems from their declared component access
+		TransformResolveSystem* transform_system = nullptr;
+		SpatialIndexSystem* spatial_index_system = nullptr;
+		RenderListSystem* render_list_system = nullptr;
+		std::unique_ptr<EntitySystemSet> simulate_systems;
+
 		LegacyBackend* legacy_backend;
 		BaseImGui* ui_renderer;
 		ResourceManager* resource_manager = nullptr;
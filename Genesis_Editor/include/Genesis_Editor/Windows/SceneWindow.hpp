@@ -12,11 +12,12 @@ namespace Genesis
 	class SceneWindow
 	{
 	public:
-		SceneWindow(InputManager* input_manager, LegacyBackend* legacy_backend);
+		SceneWindow(InputManager* input_manager, LegacyBackend* legacy_backend, JobSystem* job_system);
 		~SceneWindow();
 
-		void update(TimeStep time_step);
-		void draw(SceneRenderList& render_list, SceneLightingSettings& lighting, Entity selected_entity = Entity());
+		//Must be called while the simulation isn't running, applies the last gizmo edit and copies the selected entity's transform for draw
+		void update(TimeStep time_step, Entity selected_entity = Entity());
+		void draw(SceneRenderList& render_list, SceneLightingSettings& lighting);
 
 		TransformD get_scene_camera_transform() { return this->scene_camera_transform; };
 
@@ -34,6 +35,11 @@ namespace Genesis
 		Camera scene_camera;
 		TransformD scene_camera_transform;
 
+		//draw runs alongside the simulation, so the gizmo works on a copy of the transform that is written back in update
+		Entity gizmo_entity;
+		TransformD gizmo_transform;
+		bool gizmo_edited = false;
+
 		//meters per second
 		double linear_speed = 2.0;
 		//rads per second
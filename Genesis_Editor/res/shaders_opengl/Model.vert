@@ -6,6 +6,10 @@ layout(location = 2) in vec3 in_tangent;
 layout(location = 3) in vec3 in_bitangent;
 layout(location = 4) in vec2 in_uv;
 
+//Per instance, see LegacyBackend::instance_attribute_location
+layout(location = 8) in mat4 in_model_matrix;
+layout(location = 12) in mat3 in_normal_matrix;
+
 layout(location = 0) out vec3 frag_world_pos;
 layout(location = 1) out vec2 frag_uv;
 layout(location = 2) out mat3 frag_tangent_space;
@@ -18,23 +22,16 @@ struct Environment
 };
 uniform Environment environment;
 
-struct Matrices
-{
-	mat4 model;
-	mat3 normal;
-};
-uniform Matrices matrices;
-
 void main()
 {
-	vec4 vert_position = matrices.model * vec4(in_position, 1.0);	
+	vec4 vert_position = in_model_matrix * vec4(in_position, 1.0);	
     gl_Position = environment.view_projection_matrix * vert_position;
 	frag_world_pos = vert_position.xyz;
 	
 	frag_uv = in_uv;
 	
-	vec3 T = normalize(matrices.normal * in_tangent);
-	vec3 B = normalize(matrices.normal * in_bitangent);	
-	vec3 N = normalize(matrices.normal * in_normal);
+	vec3 T = normalize(in_normal_matrix * in_tangent);
+	vec3 B = normalize(in_normal_matrix * in_bitangent);	
+	vec3 N = normalize(in_normal_matrix * in_normal);
 	frag_tangent_space = mat3(T, B, N);
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#version 450
+
+layout(location = 0) in vec3 frag_world_pos;
+layout(location = 1) in vec2 frag_uv;
+layout(location = 2) in mat3 frag_tangent_space;
+
+#include "Environment.slib"
+uniform Environment environment;
+
+#include "Material.slib"
+uniform Material material;
+
+#include "Clusters.slib"
+uniform Clusters clusters;
+
+#include "Pbr.slib"
+
+layout(location = 0) out vec4 out_color;
+void main()
+{
+	vec4 full_albedo = getAlbedo(material);
+	vec3 normal = getNormal(material);
+	vec2 metallic_roughness = getMetallicRoughness(material);
+	vec3 frag_to_cam_dir = normalize(environment.camera_position - frag_world_pos);
+	PbrMaterial pbr_material = PbrMaterial(full_albedo.xyz, metallic_roughness.x, metallic_roughness.y, metallic_roughness.y * metallic_roughness.y);
+
+	vec3 color = full_albedo.xyz * environment.ambient_light * getOcclusion(material);
+
+	for (uint i = 0; i < clusters.directional_light_count; i++)
+	{
+		ClusterLight light = cluster_lights[i];
+		vec3 radiance = light.color_intensity.xyz * light.color_intensity.w;
+		color += calcDirectLight(pbr_material, normal, frag_to_cam_dir, -light.direction_cutoff.xyz, radiance);
+	}
+
+	uvec2 cluster_range = cluster_ranges[getClusterIndex(clusters, frag_world_pos)];
+	for (uint i = 0; i < cluster_range.y; i++)
+	{
+		ClusterLight light = cluster_lights[cluster_light_indices[cluster_range.x + i]];
+		vec3 frag_to_light = light.position_range.xyz - frag_world_pos;
+		float light_distance = length(frag_to_light);
+		vec3 frag_to_light_dir = frag_to_light / light_distance;
+
+		//Point lights have a cutoff below -1, so only spot lights can fail this
+		if (light_distance > light.position_range.w || dot(-frag_to_light_dir, light.direction_cutoff.xyz) < light.direction_cutoff.w)
+		{
+			continue;
+		}
+
+		float distance = light_distance / light.position_range.w;
+		float attenuation = (light.attenuation.x / distance) + (light.attenuation.y / (distance * distance));
+		attenuation = max(attenuation, 0.0001);
+		vec3 radiance = (light.color_intensity.xyz * light.color_intensity.w) * attenuation;
+
+		color += calcDirectLight(pbr_material, normal, frag_to_cam_dir, frag_to_light_dir, radiance);
+	}
+
+	out_color = vec4(color, full_albedo.w) + getEmissive(material);
+}
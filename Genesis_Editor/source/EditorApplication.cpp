@@ -10,6 +10,16 @@
 #include "imgui.h"
 
 #include "Genesis/Scene/SceneSerializer.hpp"
+#include "Genesis/Physics/PhysicsWorld.hpp"
+#include "Genesis/Physics/RigidBody.hpp"
+
+//Hierarchy changes allowed before the ChildNode pool is sorted again
+#define hierarchy_sort_min_changes 256
+
+#define editor_frame_rate_limit 144.0
+
+//Cell size worlds are saved with
+#define world_cell_size 128.0
 
 namespace Genesis
 {
@@ -25,12 +35,87 @@ namespace Genesis
 
 		this->entity_hierarchy_window = std::make_unique<EntityHierarchyWindow>(this->resource_manager);
 		this->entity_properties_window = std::make_unique<EntityPropertiesWindow>(this->resource_manager);
-		this->scene_window = std::make_unique<SceneWindow>(this->input_manager, this->legacy_backend);
+		this->scene_window = std::make_unique<SceneWindow>(this->input_manager, this->legacy_backend, this->job_system);
 		this->asset_browser_window = std::make_unique<AssetBrowserWindow>(this->legacy_backend, "res/");
 		this->material_editor_window = std::make_unique<MaterialEditorWindow>(this->resource_manager);
 		this->render_statistics_window = std::make_unique<RenderStatisticsWindow>(this->legacy_backend);
 
 		this->editor_scene = new Scene();
+
+		//The editor doesn't need to redraw any faster than this, without a limit it just burns a core
+		this->frame_rate_limit = editor_frame_rate_limit;
+
+		this->transform_system = new TransformResolveSystem(this->job_system);
+		this->spatial_index_system = new SpatialIndexSystem();
+		this->render_list_system = new RenderListSystem(this->job_system);
+
+		this->simulate_systems = std::make_unique<EntitySystemSet>(this->job_system);
+		this->simulate_systems->add_system(this->transform_system);
+		this->simulate_systems->add_system(this->render_list_system);
+		this->simulate_systems->add_system(this->spatial_index_system);
+
+		//Update Graph, everything that has to run while the simulation isn't
+		{
+			TaskNodeId input_node = this->update_graph.addNode("Input", [this]()
+			{
+				this->Application::update(this->frame_time_step);
+			}, true);
+
+			TaskNodeId camera_node = this->update_graph.addNode("Scene Camera", [this]()
+			{
+				this->scene_window->update(this->frame_time_step, this->entity_hierarchy_window->get_selected());
+			}, true);
+
+			//Creates and destroys entities, so it has to be done before the simulation starts
+			//Paused while playing, restoring the snapshot would bring back cells that were streamed out
+			TaskNodeId streaming_node = this->update_graph.addNode("World Streaming", [this]()
+			{
+				if (this->world_partition && !this->is_playing)
+				{
+					this->world_partition->update(this->scene_window->get_scene_camera_transform().getPosition());
+				}
+			}, true);
+
+			//The UI can edit the scene, so it has to be done before the simulation starts
+			TaskNodeId ui_node = this->update_graph.addNode("UI", [this]()
+			{
+				this->draw_ui();
+			}, true);
+
+			this->update_graph.addEdge(input_node, camera_node);
+			this->update_graph.addEdge(camera_node, streaming_node);
+			this->update_graph.addEdge(streaming_node, ui_node);
+		}
+
+		//Simulate Graph, runs on the job threads while the last frame is drawn
+		{
+			//Physics itself steps in fixedUpdate, this blends the last two steps by how far this frame is into the next one
+			//The blend is only used for drawing, gameplay, saving and the play snapshot all see the Transform of the last step
+			TaskNodeId physics_node = this->simulate_graph.addNode("Physics Interpolation", [this]()
+			{
+				if (!this->is_playing)
+				{
+					return;
+				}
+
+				const double interpolation_value = this->getInterpolationValue();
+				auto view = this->editor_scene->registry.view<InterpolatedTransform>();
+				for (EntityHandle entity : view)
+				{
+					InterpolatedTransform& interpolated_transform = view.get<InterpolatedTransform>(entity);
+					interpolated_transform.render = TransformUtils::interpolate(interpolated_transform.previous, interpolated_transform.current, interpolation_value);
+				}
+			});
+
+			//Ordered from the systems' declared access, the transform resolve is structural so it runs alone
+			//and the render list and spatial index only read the result, so they run alongside each other
+			TaskNodeId systems_node = this->simulate_graph.addNode("Entity Systems", [this]()
+			{
+				this->simulate_systems->run_systems(this->editor_scene, this->simulate_time_step);
+			});
+
+			this->simulate_graph.addEdge(physics_node, systems_node);
+		}
 	}
 
 	EditorApplication::~EditorApplication()
@@ -43,6 +128,13 @@ namespace Genesis
 		this->material_editor_window.release();
 		this->render_statistics_window.release();
 
+		//Has to finish any cell still loading before the scene goes
+		this->world_partition.reset();
+
+		this->simulate_systems.reset();
+		delete this->transform_system;
+		delete this->spatial_index_system;
+		delete this->render_list_system;
 		delete this->editor_scene;
 		delete this->resource_manager;
 		delete this->legacy_backend;
@@ -51,11 +143,53 @@ namespace Genesis
 	void EditorApplication::update(TimeStep time_step)
 	{
 		GENESIS_PROFILE_FUNCTION("EditorApplication::update");
-		Application::update(time_step);
-		this->scene_window->update(time_step);
+		this->frame_time_step = time_step;
+		this->update_graph.execute(this->job_system);
+
+		//The UI may have opened a scene or restored the play snapshot, both replace the registry
+		//Nothing else is using it until the simulate job starts, so the systems can make their structural changes here
+		this->simulate_systems->setup_systems(this->editor_scene);
 	}
 
-	void build_scene_render_list(Scene* scene);
+	void EditorApplication::fixedUpdate(TimeStep fixed_time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("EditorApplication::fixedUpdate");
+
+		//The scene only simulates while playing, in edit mode the Transforms belong to the gizmo and property windows
+		if (!this->is_playing || !this->editor_scene->scene_components.has<PhysicsWorld>())
+		{
+			return;
+		}
+
+		this->editor_scene->scene_components.get<PhysicsWorld>().simulate(fixed_time_step);
+
+		//Runs before the simulate graph on the same job, so adding the component here doesn't race with anything
+		//Only bodies that actually moved get re-resolved, so sleeping bodies cost nothing downstream
+		auto view = this->editor_scene->registry.view<RigidBody, Transform>(entt::exclude<ChildNode>);
+		for (EntityHandle entity : view)
+		{
+			Transform& transform = view.get<Transform>(entity);
+			Transform body_transform = transform;
+			view.get<RigidBody>(entity).getTransform(body_transform);
+
+			InterpolatedTransform& interpolated_transform = this->editor_scene->registry.get_or_emplace<InterpolatedTransform>(entity, body_transform, body_transform, body_transform);
+			interpolated_transform.previous = interpolated_transform.current;
+			interpolated_transform.current = body_transform;
+
+			if (transform != body_transform)
+			{
+				transform = body_transform;
+				TransformResolveSystem::markDirty(this->editor_scene->registry, entity);
+			}
+		}
+	}
+
+	void EditorApplication::simulate(TimeStep time_step)
+	{
+		GENESIS_PROFILE_FUNCTION("EditorApplication::simulate");
+		this->simulate_time_step = time_step;
+		this->simulate_graph.execute(this->job_system);
+	}
 
 	void EditorApplication::render(TimeStep time_step)
 	{
@@ -63,6 +197,29 @@ namespace Genesis
 
 		Application::render(time_step);
 
+		this->draw_scene_view();
+	}
+
+	void EditorApplication::finishFrame()
+	{
+		//The list the simulation just built gets drawn next frame
+		this->editor_scene->render_lists.swap();
+
+		//Nothing else is using the registry between frames
+		ComponentEvents::clearChanges(this->editor_scene->registry);
+		HierarchyUtils::sortDepthFirstIfNeeded(this->editor_scene->registry, hierarchy_sort_min_changes);
+
+		if (this->dump_frame_graph)
+		{
+			GENESIS_ENGINE_INFO("Update {}", this->update_graph.dump());
+			GENESIS_ENGINE_INFO("Simulate {}", this->simulate_graph.dump());
+			GENESIS_ENGINE_INFO("Entity Systems {}", this->simulate_systems->dump());
+			this->dump_frame_graph = false;
+		}
+	}
+
+	void EditorApplication::draw_ui()
+	{
 		this->legacy_backend->startFrame();
 		vector4F clear_color = vector4F(0.0f, 0.0f, 0.0f, 1.0f);
 		float clear_depth = 1.0f;
@@ -80,8 +237,26 @@ namespace Genesis
 
 					if (!save_file_path.empty())
 					{
+						this->world_partition.reset();
 						delete this->editor_scene;
 						this->editor_scene = SceneSerializer().deserialize(save_file_path.c_str(), this->resource_manager);
+						this->play_snapshot.clear();
+						this->is_playing = false;
+					}
+				}
+
+				if (ImGui::MenuItem("Open World", ""))
+				{
+					string save_file_path = FileSystem::openFileDialog("Supported Files(*.world)\0*.world;\0All files(*.*)\0*.*\0");
+
+					if (!save_file_path.empty())
+					{
+						this->world_partition.reset();
+						delete this->editor_scene;
+						this->editor_scene = new Scene();
+						this->world_partition = std::make_unique<WorldPartition>(save_file_path.c_str(), this->editor_scene, this->resource_manager, this->job_system);
+						this->play_snapshot.clear();
+						this->is_playing = false;
 					}
 				}
 
@@ -95,13 +270,51 @@ namespace Genesis
 					}
 				}
 
+				//Only whole scenes can be split up, an open world only has the cells near the camera loaded
+				if (ImGui::MenuItem("Save As World", "", false, !this->world_partition))
+				{
+					string save_file_path = FileSystem::saveFileDialog("Supported Files(*.world)\0*.world;\0All files(*.*)\0*.*\0");
+
+					if (!save_file_path.empty())
+					{
+						WorldPartition::save(this->editor_scene, save_file_path.c_str(), world_cell_size);
+					}
+				}
+
 				if (ImGui::MenuItem("Exit", "")) { this->close(); };
 				ImGui::EndMenu();
 			}
 
+			//Update runs before the simulation job starts, so the scene can be swapped out here
+			if (ImGui::BeginMenu("Scene"))
+			{
+				if (ImGui::MenuItem("Play", "", false, !this->is_playing))
+				{
+					this->play_snapshot.capture(this->editor_scene);
+					this->editor_scene->initialize_scene();
+					this->is_playing = true;
+				}
+
+				if (ImGui::MenuItem("Stop", "", false, this->is_playing))
+				{
+					//Physics bodies belong to the world that's about to be replaced, so they have to go first
+					//Nothing is simulated in edit mode, a leftover blend would keep drawing bodies where they were when play stopped
+					this->editor_scene->deinitialize_scene();
+					this->editor_scene->registry.clear<InterpolatedTransform>();
+					this->play_snapshot.restore(this->editor_scene);
+					this->play_snapshot.clear();
+					this->is_playing = false;
+				}
+				ImGui::EndMenu();
+			}
+
 			if (ImGui::BeginMenu("Tools"))
 			{
 				ImGui::MenuItem("Imgui Demo", nullptr, &this->show_demo_window);
+				if (ImGui::MenuItem("Dump Frame Graph", ""))
+				{
+					this->dump_frame_graph = true;
+				}
 				ImGui::EndMenu();
 			}
 
@@ -109,14 +322,17 @@ namespace Genesis
 		}
 		this->ui_renderer->endDocking();
 
-		this->render_statistics_window->draw(time_step);
+		this->render_statistics_window->draw(this->frame_time_step);
 		this->entity_hierarchy_window->draw(this->editor_scene);
 		this->entity_properties_window->draw(this->entity_hierarchy_window->get_selected());
 		this->asset_browser_window->draw();
 		this->material_editor_window->draw();
+	}
 
-		build_scene_render_list(this->editor_scene);
-		this->scene_window->draw(this->editor_scene->render_list, this->editor_scene->lighting_settings, this->entity_hierarchy_window->get_selected());
+	void EditorApplication::draw_scene_view()
+	{
+		//Only the read list is safe here, the simulation is writing the other one
+		this->scene_window->draw(this->editor_scene->render_lists.getReadList(), this->editor_scene->lighting_settings);
 
 		if (this->show_demo_window)
 		{
@@ -127,63 +343,4 @@ namespace Genesis
 
 		this->legacy_backend->endFrame();
 	}
-
-
-#include "Genesis/Component/ModelComponent.hpp"
-#include "Genesis/Rendering/Camera.hpp"
-#include "Genesis/Rendering/Lights.hpp"
-
-	void add_to_render_list(SceneRenderList& render_list, EntityRegistry& registry, EntityHandle entity, const TransformD& parent_transform)
-	{
-		TransformD world_transform = parent_transform;
-
-		if (registry.has<TransformD>(entity))
-		{
-			TransformUtils::transformByInplace(world_transform, parent_transform, registry.get<TransformD>(entity));
-		}
-
-		if (registry.has<ModelComponent>(entity))
-		{
-			ModelComponent& model = registry.get<ModelComponent>(entity);
-			render_list.models.push_back({ model.mesh, model.material, world_transform });
-		}
-
-		if (registry.has<DirectionalLight>(entity))
-		{
-			DirectionalLight& light = registry.get<DirectionalLight>(entity);
-			render_list.directional_lights.push_back({ light, world_transform });
-		}
-
-		if (registry.has<PointLight>(entity))
-		{
-			PointLight& light = registry.get<PointLight>(entity);
-			render_list.point_lights.push_back({ light, world_transform });
-		}
-
-		if (registry.has<SpotLight>(entity))
-		{
-			SpotLight& light = registry.get<SpotLight>(entity);
-			render_list.spot_lights.push_back({ light, world_transform });
-		}
-
-		for (EntityHandle child : EntityHiearchy(&registry, entity))
-		{
-			add_to_render_list(render_list, registry, child, world_transform);
-		}
-	}
-
-	void build_scene_render_list(Scene* scene)
-	{
-		scene->render_list.clear();
-		scene->registry.each([&](auto entity)
-		{
-			if (entity != scene->scene_components.handle())
-			{
-				if (!scene->registry.has<ChildNode>(entity))
-				{
-					add_to_render_list(scene->render_list, scene->registry, entity, TransformD());
-				}
-			}
-		});
-	}
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "Genesis/Rendering/Lights.hpp"
 
 #include "Genesis/Scene/Entity.hpp"
+#include "Genesis/System/TransformResolveSystem.hpp"
 
 namespace Genesis
 {
@@ -69,24 +70,34 @@ namespace Genesis
 			ImGui::InputText("Entity Name", name_component.data, name_component.SIZE);
 		});
 
-		draw_component<Transform>(entity, "Transform", [](Transform& transform_component)
+		draw_component<Transform>(entity, "Transform", [&entity](Transform& transform_component)
 		{
+			bool changed = false;
+
 			vector3D position = transform_component.getPosition();
 			if (ImGui::InputScalarN("Position", ImGuiDataType_::ImGuiDataType_Double, &position, 3))
 			{
 				transform_component.setPosition(position);
+				changed = true;
 			};
 
 			vector3D rotation = glm::degrees(glm::eulerAngles(transform_component.getOrientation()));
 			if (ImGui::InputScalarN("Rotation", ImGuiDataType_::ImGuiDataType_Double, &rotation, 3))
 			{
 				transform_component.setOrientation(quaternionD(glm::radians(rotation)));
+				changed = true;
 			}
 
 			vector3D scale = transform_component.getScale();
 			if (ImGui::InputScalarN("Scale", ImGuiDataType_::ImGuiDataType_Double, &scale, 3))
 			{
 				transform_component.setScale(scale);
+				changed = true;
+			}
+
+			if (changed)
+			{
+				TransformResolveSystem::markDirty(entity.get_scene()->registry, entity.handle());
 			}
 		});
 
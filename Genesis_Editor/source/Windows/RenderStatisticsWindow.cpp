@@ -15,6 +15,10 @@ namespace Genesis
 		ImGui::Text("Frame Time (ms): %.2f", time_step * 1000.0);
 		ImGui::Text("Draw Calls     : %u", stats.draw_calls);
 		ImGui::Text("Tris count     : %u", stats.triangles_count);
+		ImGui::Text("Buffer Binds   : %u", stats.buffer_binds);
+		ImGui::Text("Texture Binds  : %u", stats.texture_binds);
+		ImGui::Text("Models Drawn   : %u", stats.models_drawn);
+		ImGui::Text("Models Culled  : %u", stats.models_culled);
 		ImGui::End();
 	}
 }
\ No newline at end of file
@@ -10,14 +10,16 @@
 #include "ImGuizmo.h"
 #include "ImGuizmo.cpp"
 
+#include "Genesis/System/TransformResolveSystem.hpp"
+
 namespace Genesis
 {
-	SceneWindow::SceneWindow(InputManager* input_manager, LegacyBackend* legacy_backend)
+	SceneWindow::SceneWindow(InputManager* input_manager, LegacyBackend* legacy_backend, JobSystem* job_system)
 	{
 		this->input_manager = input_manager;
 
 		this->legacy_backend = legacy_backend;
-		this->world_renderer = new LegacySceneRenderer(this->legacy_backend);
+		this->world_renderer = new LegacySceneRenderer(this->legacy_backend, job_system);
 
 		this->scene_camera_transform.setPosition(vector3D(0.0, 0.0, -5.0));
 	}
@@ -55,8 +57,25 @@ namespace Genesis
 	constexpr fnv_hash32 debug_roll_left = StringHash32("Debug_RollLeft");
 	constexpr fnv_hash32 debug_roll_right = StringHash32("Debug_RollRight");
 
-	void SceneWindow::update(TimeStep time_step)
-	{		
+	void SceneWindow::update(TimeStep time_step, Entity selected_entity)
+	{
+		//Only write back if the selection hasn't changed, the UI may have swapped out the scene since the last draw
+		bool same_entity = (selected_entity.get_scene() == this->gizmo_entity.get_scene()) && (selected_entity.handle() == this->gizmo_entity.handle());
+		bool has_transform = selected_entity.valid() && selected_entity.has<TransformD>();
+
+		if (this->gizmo_edited && same_entity && has_transform)
+		{
+			selected_entity.get<TransformD>() = this->gizmo_transform;
+			TransformResolveSystem::markDirty(selected_entity.get_scene()->registry, selected_entity.handle());
+		}
+		this->gizmo_edited = false;
+
+		this->gizmo_entity = has_transform ? selected_entity : Entity();
+		if (has_transform)
+		{
+			this->gizmo_transform = selected_entity.get<TransformD>();
+		}
+		
 		if (this->window_active)
 		{
 			vector3D position = this->scene_camera_transform.getPosition();
@@ -73,7 +92,7 @@ namespace Genesis
 		}
 	}
 
-	void SceneWindow::draw(SceneRenderList& render_list, SceneLightingSettings& lighting, Entity selected_entity)
+	void SceneWindow::draw(SceneRenderList& render_list, SceneLightingSettings& lighting)
 	{
 		ImGui::Begin("Scene View", nullptr, ImGuiWindowFlags_MenuBar);
 
@@ -202,9 +221,9 @@ namespace Genesis
 
 
 		//ImGuizmo
-		if (selected_entity.valid() && selected_entity.has<TransformD>())
+		if (this->gizmo_entity.get_scene() != nullptr)
 		{
-			TransformD& transform = selected_entity.get<TransformD>();
+			TransformD& transform = this->gizmo_transform;
 
 			ImGuizmo::SetOrthographic(false);
 			ImGuizmo::BeginFrame();
@@ -238,6 +257,7 @@ namespace Genesis
 				}
 
 				transform.setScale((vector3D)scale);
+				this->gizmo_edited = true;
 			}
 		}
 
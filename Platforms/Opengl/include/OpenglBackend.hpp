@@ -103,10 +103,16 @@ namespace Genesis
 			virtual void bindIndexBuffer(IndexBuffer buffer) override;
 			virtual void drawIndex(uint32_t index_count, uint32_t index_offset = 0) override;
 
+			virtual void uploadInstanceBuffer(const void* data, uint64_t data_size, const VertexInputDescriptionCreateInfo& instance_description) override;
+			virtual void drawIndexInstanced(uint32_t index_count, uint32_t instance_count, uint32_t first_instance, uint32_t index_offset = 0) override;
+
+			virtual void uploadStorageBuffer(uint32_t binding, const void* data, uint64_t data_size) override;
+
 			virtual void draw(VertexBuffer vertex_buffer, IndexBuffer index_buffer, uint32_t triangle_count) override;
 
 			virtual void dispatchCompute(uint32_t groups_x = 1, uint32_t groups_y = 1, uint32_t groups_z = 1) override;
 
+			virtual void addModelStats(uint64_t models_drawn, uint64_t models_culled) override;
 			virtual FrameStats getLastFrameStats() override;
 
 		protected:
@@ -118,9 +124,23 @@ namespace Genesis
 			OpenglVertexBuffer* vertex_buffer = nullptr;
 			OpenglIndexBuffer* index_buffer = nullptr;
 
+			//Grown as needed and orphaned on every upload, so a frame never waits on the last one's draws
+			GLuint instance_buffer = 0;
+			uint64_t instance_buffer_size = 0;
+			vector<VertexElementType> instance_elements;
+			uint32_t instance_stride = 0;
+
+			//Same as the instance buffer, one per binding
+			struct OpenglStorageBuffer
+			{
+				GLuint buffer = 0;
+				uint64_t size = 0;
+			};
+			flat_hash_map<uint32_t, OpenglStorageBuffer> storage_buffers;
+
 			//Stats
-			FrameStats last_frame_stats;
-			FrameStats current_frame_stats;
+			FrameStats last_frame_stats = {};
+			FrameStats current_frame_stats = {};
 		};
 	}
 }
\ No newline at end of file
@@ -59,6 +59,16 @@ namespace Genesis
 
 		OpenglBackend::~OpenglBackend()
 		{
+			if (this->instance_buffer != 0)
+			{
+				glDeleteBuffers(1, &this->instance_buffer);
+			}
+
+			for (auto& pair : this->storage_buffers)
+			{
+				glDeleteBuffers(1, &pair.second.buffer);
+			}
+
 			this->window->GL_DeleteContext(this->opengl_context);
 		}
 
@@ -92,7 +102,7 @@ namespace Genesis
 			this->window->GL_UpdateBuffer();
 
 			this->last_frame_stats = current_frame_stats;
-			current_frame_stats = { 0, 0 };
+			current_frame_stats = {};
 		}
 
 		GLenum getVertexElementType(VertexElementType type)
@@ -732,6 +742,8 @@ namespace Genesis
 			glActiveTexture(GL_TEXTURE0 + texture_slot);
 			glBindTexture(GL_TEXTURE_2D, ((OpenglTexture2D*)value)->texture_handle);
 			glUniform1i(current_program->getUniformLocation(name), texture_slot);
+
+			this->current_frame_stats.texture_binds++;
 		}
 
 		void OpenglBackend::setUniformTextureImage(const string& name, const uint32_t texture_slot, Texture2D value)
@@ -764,6 +776,8 @@ namespace Genesis
 			{
 				glBindVertexArray(0);
 			}
+
+			this->current_frame_stats.buffer_binds++;
 		}
 
 		void OpenglBackend::bindIndexBuffer(IndexBuffer buffer)
@@ -778,6 +792,8 @@ namespace Genesis
 			{
 				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 			}
+
+			this->current_frame_stats.buffer_binds++;
 		}
 
 		void OpenglBackend::drawIndex(uint32_t index_count, uint32_t index_offset)
@@ -795,6 +811,96 @@ namespace Genesis
 			this->current_frame_stats.triangles_count += index_count / 3;
 		}
 
+		void OpenglBackend::uploadInstanceBuffer(const void* data, uint64_t data_size, const VertexInputDescriptionCreateInfo& instance_description)
+		{
+			if (this->instance_buffer == 0)
+			{
+				glGenBuffers(1, &this->instance_buffer);
+			}
+
+			glBindBuffer(GL_ARRAY_BUFFER, this->instance_buffer);
+			if (data_size > this->instance_buffer_size)
+			{
+				glBufferData(GL_ARRAY_BUFFER, data_size, data, GL_STREAM_DRAW);
+				this->instance_buffer_size = data_size;
+			}
+			else
+			{
+				glBufferData(GL_ARRAY_BUFFER, this->instance_buffer_size, nullptr, GL_STREAM_DRAW);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, data);
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			this->instance_elements.assign(instance_description.input_elements, instance_description.input_elements + instance_description.input_elements_count);
+			this->instance_stride = 0;
+			for (VertexElementType element : this->instance_elements)
+			{
+				this->instance_stride += VertexElementTypeInfo::getInputElementSizeByte(element);
+			}
+		}
+
+		void OpenglBackend::drawIndexInstanced(uint32_t index_count, uint32_t instance_count, uint32_t first_instance, uint32_t index_offset)
+		{
+			GENESIS_ENGINE_ASSERT(this->vertex_buffer != nullptr, "Vertex Buffer Not Bound");
+			GENESIS_ENGINE_ASSERT(this->instance_buffer != 0, "Instance Buffer Not Uploaded");
+
+			//The attribute pointers are stored in the bound vertex array, first_instance goes into the offset so no base instance support is needed
+			glBindBuffer(GL_ARRAY_BUFFER, this->instance_buffer);
+			size_t offset = (size_t)first_instance * this->instance_stride;
+			for (uint32_t i = 0; i < (uint32_t)this->instance_elements.size(); i++)
+			{
+				const GLuint location = instance_attribute_location + i;
+				glEnableVertexAttribArray(location);
+				glVertexAttribPointer(location, VertexElementTypeInfo::getInputElementCount(this->instance_elements[i]), getVertexElementType(this->instance_elements[i]), GL_FALSE, this->instance_stride, (void*)offset);
+				glVertexAttribDivisor(location, 1);
+				offset += VertexElementTypeInfo::getInputElementSizeByte(this->instance_elements[i]);
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			if (this->index_buffer->type == IndexType::uint32)
+			{
+				glDrawElementsInstanced(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, (void*)(index_offset * sizeof(GLuint)), instance_count);
+			}
+			else
+			{
+				glDrawElementsInstanced(GL_TRIANGLES, index_count, GL_UNSIGNED_SHORT, (void*)(index_offset * sizeof(GLushort)), instance_count);
+			}
+
+			this->current_frame_stats.draw_calls++;
+			this->current_frame_stats.triangles_count += (uint64_t)(index_count / 3) * instance_count;
+		}
+
+		void OpenglBackend::uploadStorageBuffer(uint32_t binding, const void* data, uint64_t data_size)
+		{
+			OpenglStorageBuffer& storage_buffer = this->storage_buffers[binding];
+			if (storage_buffer.buffer == 0)
+			{
+				glGenBuffers(1, &storage_buffer.buffer);
+			}
+
+			//A zero sized buffer can't be bound, empty uploads still get a little space
+			const uint64_t buffer_size = std::max(data_size, (uint64_t)16);
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, storage_buffer.buffer);
+			if (buffer_size > storage_buffer.size)
+			{
+				glBufferData(GL_SHADER_STORAGE_BUFFER, buffer_size, nullptr, GL_STREAM_DRAW);
+				storage_buffer.size = buffer_size;
+			}
+			else
+			{
+				glBufferData(GL_SHADER_STORAGE_BUFFER, storage_buffer.size, nullptr, GL_STREAM_DRAW);
+			}
+
+			if (data_size > 0)
+			{
+				glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, data_size, data);
+			}
+
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, storage_buffer.buffer);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		}
+
 		void OpenglBackend::draw(VertexBuffer vertex_buffer, IndexBuffer index_buffer, uint32_t triangle_count)
 		{
 			OpenglVertexBuffer* vertex = (OpenglVertexBuffer*)vertex_buffer;
@@ -818,6 +924,12 @@ namespace Genesis
 			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 		}
 
+		void OpenglBackend::addModelStats(uint64_t models_drawn, uint64_t models_culled)
+		{
+			this->current_frame_stats.models_drawn += models_drawn;
+			this->current_frame_stats.models_culled += models_culled;
+		}
+
 		FrameStats OpenglBackend::getLastFrameStats()
 		{
 			return this->last_frame_stats;
@@ -23,7 +23,7 @@ namespace Genesis
 
 		this->sandbox_scene = new Scene();
 
-		this->world_renderer = new LegacySceneRenderer(this->legacy_backend);
+		this->world_renderer = new LegacySceneRenderer(this->legacy_backend, this->job_system);
 	}
 
 	SandboxApplication::~SandboxApplication()